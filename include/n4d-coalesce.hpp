@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef EDUPALS_N4D_COALESCE
+#define EDUPALS_N4D_COALESCE
+
+#include <variant.hpp>
+
+#include <string>
+#include <set>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+namespace edupals
+{
+    namespace n4d
+    {
+        /*!
+         * Single flight coalescing of identical idempotent calls. While a
+         * request is in flight, identical requests from other threads wait
+         * for it and get the same raw response body, each caller parses
+         * its own copy. May be shared among clients
+        */
+        class Coalescer
+        {
+            public:
+            
+            /*!
+             * Read only builtins are coalesced by default
+            */
+            Coalescer();
+            
+            Coalescer(const Coalescer&) = delete;
+            Coalescer& operator=(const Coalescer&) = delete;
+            
+            /*!
+             * Marks plugin::method() as idempotent, use N4D as name for
+             * builtin methods
+            */
+            void add(std::string name,std::string method);
+            
+            void remove(std::string name,std::string method);
+            
+            /*!
+             * Whenever plugin::method() calls can be coalesced
+            */
+            bool idempotent(const std::string& name,const std::string& method);
+            
+            /*!
+             * Runs function unless another caller is already running it
+             * with same key, in that case waits for its result.
+             * Exceptions are propagated to every caller.
+            */
+            variant::Variant run(const std::string& key,std::function<variant::Variant()> function);
+            
+            /*!
+             * Requests actually sent
+            */
+            uint64_t get_flights();
+            
+            /*!
+             * Calls served by another call's request
+            */
+            uint64_t get_coalesced();
+            
+            /*!
+             * Requests currently in flight
+            */
+            int64_t get_in_flight();
+            
+            /*!
+             * Gets counters as a Variant, totals as doubles
+            */
+            variant::Variant stats();
+            
+            protected:
+            
+            class Flight
+            {
+                public:
+                
+                std::mutex mutex;
+                std::condition_variable ready;
+                bool done = false;
+                variant::Variant value;
+                std::exception_ptr error;
+            };
+            
+            std::mutex mutex;
+            std::map<std::string,std::shared_ptr<Flight> > flights;
+            std::set<std::string> methods;
+            
+            std::atomic<uint64_t> sent;
+            std::atomic<uint64_t> coalesced;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef EDUPALS_N4D_METRICS
+#define EDUPALS_N4D_METRICS
+
+#include <n4d.hpp>
+#include <variant.hpp>
+
+#include <string>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+namespace edupals
+{
+    namespace n4d
+    {
+        /*!
+         * Lock-free log-linear latency histogram. Each power of two is split
+         * into 8 buckets, so recorded values keep a 12.5% precision
+        */
+        class Histogram
+        {
+            public:
+            
+            static const int SubBuckets = 8;
+            static const int Buckets = 312;
+            
+            Histogram();
+            
+            Histogram(const Histogram&) = delete;
+            Histogram& operator=(const Histogram&) = delete;
+            
+            /*!
+             * Records a value, expressed in microseconds
+            */
+            void record(int64_t value);
+            
+            uint64_t count();
+            int64_t sum();
+            int64_t max();
+            
+            /*!
+             * Gets value at given percentile (0.0-100.0). Result is the
+             * upper bound of the matching bucket
+            */
+            int64_t percentile(double p);
+            
+            /*!
+             * Number of recorded values less than or equal to given value,
+             * rounded to bucket bounds
+            */
+            uint64_t count_below(int64_t value);
+            
+            void reset();
+            
+            static int bucket(int64_t value);
+            static int64_t lower_bound(int index);
+            static int64_t upper_bound(int index);
+            
+            protected:
+            
+            std::atomic<uint64_t> buckets[Buckets];
+            std::atomic<uint64_t> total;
+            std::atomic<int64_t> accum;
+            std::atomic<int64_t> maximum;
+        };
+        
+        /*!
+         * Counters of a plugin::method pair
+        */
+        class Series
+        {
+            public:
+            
+            static const int MaxStatus = 41;
+            static const int MaxCurlCode = 128;
+            
+            const std::string name;
+            const std::string method;
+            
+            std::atomic<uint64_t> calls;
+            std::atomic<uint64_t> failures;
+            std::atomic<int64_t> in_flight;
+            std::atomic<uint64_t> request_bytes;
+            std::atomic<uint64_t> response_bytes;
+            
+            /*! calls served by an identical call in flight */
+            std::atomic<uint64_t> coalesced;
+            
+            /*! failures by N4D status, indexed by -ErrorCode */
+            std::atomic<uint64_t> status_errors[MaxStatus];
+            
+            /*! failures by curl code */
+            std::atomic<uint64_t> curl_errors[MaxCurlCode];
+            
+            /*! failures not fitting in any of above, i.e. parse errors */
+            std::atomic<uint64_t> other_errors;
+            
+            Histogram latency;
+            
+            Series(std::string name,std::string method);
+            
+            Series(const Series&) = delete;
+            Series& operator=(const Series&) = delete;
+        };
+        
+        /*!
+         * Registry of call metrics, keyed by plugin name and method.
+         * Updates are lock-free, series are stored in a fixed size open
+         * addressing table and calls exceeding its capacity are accounted
+         * in an overflow series
+        */
+        class Metrics
+        {
+            public:
+            
+            Metrics(size_t capacity = 256);
+            
+            Metrics(const Metrics&) = delete;
+            Metrics& operator=(const Metrics&) = delete;
+            
+            virtual ~Metrics();
+            
+            /*!
+             * Accounts a call that has just started
+            */
+            void begin(const Trace& trace);
+            
+            /*!
+             * Accounts a finished call
+            */
+            void end(const Trace& trace);
+            
+            /*!
+             * Calls currently running on all series
+            */
+            int64_t in_flight();
+            
+            /*!
+             * Dumps metrics in Prometheus text exposition format
+            */
+            std::string to_prometheus(std::string prefix = "n4d");
+            
+            /*!
+             * Gets a snapshot of metrics as a Variant
+            */
+            variant::Variant to_variant();
+            
+            protected:
+            
+            size_t capacity;
+            std::unique_ptr<std::atomic<Series*>[]> slots;
+            Series overflow;
+            std::atomic<int64_t> running;
+            
+            Series* find(const std::string& name,const std::string& method);
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef EDUPALS_N4D_MIRROR
+#define EDUPALS_N4D_MIRROR
+
+#include <n4d.hpp>
+#include <variant.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <functional>
+#include <cstdint>
+
+namespace edupals
+{
+    namespace n4d
+    {
+        /*!
+         * Receives names of changed variables after a refresh, deleted
+         * ones included
+        */
+        typedef std::function<void(const std::vector<std::string>&)> MirrorSubscriber;
+        
+        /*!
+         * Local copy of server variables, kept up to date on refresh.
+         * Servers answering get_changes(serial) only send variables changed
+         * since last refresh, otherwise the whole set is downloaded and
+         * diffed against a digest of each variable
+        */
+        class VariableMirror
+        {
+            public:
+            
+            VariableMirror(Client client);
+            
+            VariableMirror(const VariableMirror&) = delete;
+            VariableMirror& operator=(const VariableMirror&) = delete;
+            
+            /*!
+             * Syncs with server and notifies subscribers
+             * \returns number of changed variables
+            */
+            size_t refresh();
+            
+            /*!
+             * Gets a variable value, throws exception::variable::NotFound
+            */
+            variant::Variant get(const std::string& name);
+            
+            bool exists(const std::string& name);
+            
+            std::vector<std::string> keys();
+            
+            /*!
+             * Gets all variables as a struct
+            */
+            variant::Variant snapshot();
+            
+            /*!
+             * \returns id to be used on unsubscribe
+            */
+            int subscribe(MirrorSubscriber subscriber);
+            
+            void unsubscribe(int id);
+            
+            /*!
+             * Whenever server supports incremental sync, known after
+             * first refresh
+            */
+            bool incremental();
+            
+            /*!
+             * Serial of last incremental sync
+            */
+            int64_t get_serial();
+            
+            protected:
+            
+            class Entry
+            {
+                public:
+                
+                variant::Variant value;
+                uint64_t digest;
+            };
+            
+            Client client;
+            
+            std::mutex mutex;
+            std::map<std::string,Entry> variables;
+            
+            bool delta;
+            int64_t serial;
+            
+            std::mutex subscribers_mutex;
+            std::map<int,MirrorSubscriber> subscribers;
+            int next_id;
+            
+            /*!
+             * Applies changes since last serial
+             * \returns false if server lacks get_changes
+            */
+            bool sync_changes(std::vector<std::string>& changed);
+            
+            void sync_all(std::vector<std::string>& changed);
+            
+            void notify(const std::vector<std::string>& changed);
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef EDUPALS_N4D_MOCK
+#define EDUPALS_N4D_MOCK
+
+#include <n4d.hpp>
+#include <variant.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <exception>
+
+namespace edupals
+{
+    namespace n4d
+    {
+        namespace http
+        {
+            class Listener;
+        }
+        
+        namespace mock
+        {
+            /*!
+             * Scripted plugin method, gets call arguments as an array and
+             * returns the value for response return field
+            */
+            typedef std::function<variant::Variant(variant::Variant)> Method;
+            
+            /*!
+             * Thrown from a Method to answer with a CallFailed status
+            */
+            class Failure: public std::exception
+            {
+                public:
+                
+                int code;
+                std::string msg;
+                
+                Failure(int code,std::string msg="")
+                {
+                    this->code=code;
+                    this->msg=msg;
+                }
+                
+                const char* what() const throw()
+                {
+                    return msg.c_str();
+                }
+            };
+            
+            /*!
+             * Local stand-in of a N4D server. Speaks plain http xml-rpc, so
+             * clients should use an http:// address.
+             * Besides N4D builtins it answers get_changes(serial) and its
+             * long-poll form wait_changes(serial,timeout), used by
+             * VariableMirror and Watcher
+            */
+            class Server
+            {
+                public:
+                
+                Server(size_t workers = 8);
+                
+                Server(const Server&) = delete;
+                Server& operator=(const Server&) = delete;
+                
+                virtual ~Server();
+                
+                /*!
+                 * Listens at 127.0.0.1 on given port, 0 picks a free one
+                 * \returns bound port
+                */
+                int listen(int port = 0);
+                
+                /*!
+                 * Listens on a unix socket
+                */
+                void listen_unix(std::string path);
+                
+                void start();
+                
+                void stop();
+                
+                /*!
+                 * Url to be used by clients
+                */
+                std::string get_url();
+                
+                /*!
+                 * Adds a valid user. Without users any credential is accepted
+                */
+                void add_user(std::string name,std::string password,std::vector<std::string> groups = {});
+                
+                void set_variable(std::string name,variant::Variant value,variant::Variant attribs = variant::Variant());
+                
+                void delete_variable(std::string name);
+                
+                /*!
+                 * Registers a plugin method
+                */
+                void set_method(std::string plugin,std::string method,Method function);
+                
+                /*!
+                 * Registers a plugin method with a fixed return value
+                */
+                void set_method(std::string plugin,std::string method,variant::Variant value);
+                
+                /*!
+                 * Makes plugin::method() answer with given N4D status.
+                 * Use N4D as plugin name for builtin calls.
+                */
+                void set_error(std::string plugin,std::string method,int status,int error_code = 0,std::string msg = "");
+                
+                void clear_error(std::string plugin,std::string method);
+                
+                /*!
+                 * Delay added to every response, in microseconds
+                */
+                void set_latency(int64_t latency);
+                
+                /*!
+                 * Size of string returned by MockServer::payload()
+                */
+                void set_payload(size_t bytes);
+                
+                /*!
+                 * Number of handled requests
+                */
+                uint64_t get_requests();
+                
+                /*!
+                 * Handles a xml-rpc request body
+                */
+                std::string handle(const std::string& body);
+                
+                protected:
+                
+                class Error
+                {
+                    public:
+                    int status;
+                    int error_code;
+                    std::string msg;
+                };
+                
+                std::unique_ptr<http::Listener> listener;
+                std::string url;
+                
+                std::mutex mutex;
+                
+                std::map<std::string,variant::Variant> variables;
+                
+                /*! last change serial of each variable, deleted included */
+                std::map<std::string,uint64_t> changes;
+                uint64_t serial;
+                std::condition_variable changed;
+                std::map<std::string,std::string> passwords;
+                std::map<std::string,std::vector<std::string> > groups;
+                std::map<std::string,std::string> keys;
+                std::map<std::string,std::map<std::string,Method> > plugins;
+                std::map<std::string,Error> errors;
+                
+                std::atomic<int64_t> latency;
+                std::atomic<size_t> payload;
+                std::atomic<uint64_t> requests;
+                
+                /*!
+                 * Gets N4D response of a single call
+                */
+                variant::Variant respond(std::string& method,variant::Variant& params);
+                
+                variant::Variant dispatch(std::string& method,variant::Variant& params);
+                
+                variant::Variant builtin(std::string& method,variant::Variant& params);
+                
+                /*!
+                 * Variables changed after serial, mutex must be held
+                */
+                variant::Variant changes_since(uint64_t since);
+                
+                /*!
+                 * Gets user name of a valid credential or throws
+                 * AuthenticationFailed status
+                */
+                std::string authenticate(variant::Variant credential);
+                
+                std::vector<std::string> user_groups(std::string user);
+                
+                bool auth_enabled();
+            };
+        }
+    }
+}
+
+#endif
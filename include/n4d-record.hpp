@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef EDUPALS_N4D_RECORD
+#define EDUPALS_N4D_RECORD
+
+#include <n4d.hpp>
+#include <n4d-transport.hpp>
+
+#include <string>
+#include <memory>
+#include <fstream>
+#include <chrono>
+
+namespace edupals
+{
+    namespace n4d
+    {
+        /*!
+         * A recorded request/response exchange
+        */
+        class Record
+        {
+            public:
+            
+            /*! wall clock when request was sent, microseconds since epoch */
+            int64_t when;
+            
+            /*! round trip time in microseconds */
+            int64_t duration;
+            
+            /*! transport error code, 0 on success */
+            int code;
+            
+            std::string name;
+            std::string method;
+            std::string request;
+            std::string response;
+        };
+        
+        /*!
+         * Appends exchanges to a traffic file. Each record is written with a
+         * single write, so a file can be shared among threads and processes
+        */
+        class Recorder
+        {
+            public:
+            
+            Recorder(std::string path);
+            
+            Recorder(const Recorder&) = delete;
+            Recorder& operator=(const Recorder&) = delete;
+            
+            virtual ~Recorder();
+            
+            void write(const Record& record);
+            
+            protected:
+            
+            int fd;
+        };
+        
+        /*!
+         * Sequential reader of a traffic file
+        */
+        class Player
+        {
+            public:
+            
+            Player(std::string path);
+            
+            /*!
+             * Reads next record, false at end of file
+            */
+            bool next(Record& record);
+            
+            /*!
+             * Goes back to first record
+            */
+            void rewind();
+            
+            protected:
+            
+            std::ifstream file;
+        };
+        
+        /*!
+         * Transport decorator that records every exchange going through it
+        */
+        class RecordingTransport: public Transport
+        {
+            public:
+            
+            RecordingTransport(std::shared_ptr<Transport> transport,std::shared_ptr<Recorder> recorder);
+            
+            using Transport::post;
+            
+            void post(const Message& message,std::string& response) override;
+            
+            protected:
+            
+            std::shared_ptr<Transport> transport;
+            std::shared_ptr<Recorder> recorder;
+        };
+    }
+}
+
+#endif
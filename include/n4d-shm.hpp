@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef EDUPALS_N4D_SHM
+#define EDUPALS_N4D_SHM
+
+#include <variant.hpp>
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+#define EDUPALS_N4D_DEFAULT_CACHE "/run/n4d-variables.cache"
+
+namespace edupals
+{
+    namespace n4d
+    {
+        namespace exception
+        {
+            class CacheError : public std::exception
+            {
+                private:
+                std::string msg;
+                
+                public:
+                
+                CacheError(std::string path,std::string info)
+                {
+                    msg="Shared cache "+path+": "+info;
+                }
+                
+                const char* what() const throw()
+                {
+                    return msg.c_str();
+                }
+            };
+        }
+        
+        /*!
+         * Memory mapped variable cache shared among processes of a host.
+         * A single process opens it as writer and keeps it up to date,
+         * see n4d-cache tool, readers look values up without locking, each
+         * slot is guarded by a sequence counter. Values larger than a slot
+         * are not cached
+        */
+        class SharedCache
+        {
+            public:
+            
+            enum class Status
+            {
+                Miss,
+                Found,
+                Deleted
+            };
+            
+            /*!
+             * Opens an existing cache for reading
+            */
+            SharedCache(std::string path = EDUPALS_N4D_DEFAULT_CACHE);
+            
+            /*!
+             * Creates or reuses a cache for writing, with given number of
+             * slots and slot size in bytes
+            */
+            SharedCache(std::string path,size_t slots,size_t slot_size = 1024);
+            
+            SharedCache(const SharedCache&) = delete;
+            SharedCache& operator=(const SharedCache&) = delete;
+            
+            virtual ~SharedCache();
+            
+            /*!
+             * Looks up a variable updated or touched less than max_age
+             * milliseconds ago
+            */
+            Status find(const std::string& name,int max_age,variant::Variant& value);
+            
+            /*!
+             * Stores a variable value, writer only
+             * \returns false if it does not fit
+            */
+            bool update(const std::string& name,variant::Variant value);
+            
+            /*!
+             * Records a variable as deleted, writer only
+            */
+            void remove(const std::string& name);
+            
+            /*!
+             * Stores all variables of a get_variables struct, writer only
+            */
+            void update(variant::Variant variables);
+            
+            /*!
+             * Skips cached value of a variable written by this process,
+             * until writer stores or touches it again
+            */
+            void invalidate(const std::string& name);
+            
+            /*!
+             * Marks every entry as current, to be called by writer after
+             * checking the server for changes
+            */
+            void touch();
+            
+            /*!
+             * Marks every entry as current as of checked, the time writer
+             * started checking the server
+            */
+            void touch(std::chrono::system_clock::time_point checked);
+            
+            bool writer();
+            
+            std::string get_path();
+            
+            protected:
+            
+            std::string path;
+            bool writable;
+            
+            uint8_t* memory;
+            size_t size;
+            
+            size_t slots;
+            size_t slot_size;
+            
+            /*! local writes not seen by writer yet, microseconds */
+            std::mutex written_mutex;
+            std::map<std::string,int64_t> written;
+            
+            uint8_t* slot(size_t n);
+            
+            std::atomic<int64_t>* touched_at();
+            
+            /*!
+             * Writer side lookup, returns slots if table is full
+            */
+            size_t locate(const std::string& name,uint64_t hash);
+            
+            void write(const std::string& name,uint32_t flags,const std::string& data);
+        };
+    }
+}
+
+#endif
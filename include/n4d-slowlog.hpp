@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef EDUPALS_N4D_SLOWLOG
+#define EDUPALS_N4D_SLOWLOG
+
+#include <n4d.hpp>
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <csignal>
+
+namespace edupals
+{
+    namespace n4d
+    {
+        /*!
+         * A call that went over slow log threshold
+        */
+        class SlowCall
+        {
+            public:
+            
+            std::chrono::system_clock::time_point when;
+            Trace trace;
+        };
+        
+        /*!
+         * Bounded ring buffer of calls slower than a threshold. Only calls
+         * over threshold take the lock, so it can be left enabled under load
+        */
+        class SlowLog
+        {
+            public:
+            
+            /*!
+             * threshold: microseconds
+             * capacity: number of records kept, older ones are overwritten
+             * capture: request bytes kept for each record, 0 disables capture
+             * sample: capture request of one in every sample calls
+            */
+            SlowLog(int64_t threshold,size_t capacity = 128,size_t capture = 0,uint32_t sample = 1);
+            
+            SlowLog(const SlowLog&) = delete;
+            SlowLog& operator=(const SlowLog&) = delete;
+            
+            virtual ~SlowLog();
+            
+            /*!
+             * Whenever next call should capture its request
+            */
+            bool sample();
+            
+            /*!
+             * Stores trace if it is over threshold
+            */
+            void push(const Trace& trace);
+            
+            /*!
+             * Gets stored records, from older to newer
+            */
+            std::vector<SlowCall> records();
+            
+            /*!
+             * Writes stored records in a human readable way
+            */
+            void dump(std::ostream& out);
+            
+            void clear();
+            
+            /*!
+             * Number of calls over threshold since creation, including
+             * already overwritten ones
+            */
+            uint64_t count();
+            
+            int64_t get_threshold();
+            void set_threshold(int64_t threshold);
+            
+            size_t get_capture();
+            
+            /*!
+             * Dumps given log into stderr whenever signum is received
+            */
+            static void dump_on_signal(std::shared_ptr<SlowLog> log,int signum = SIGUSR1);
+            
+            protected:
+            
+            std::atomic<int64_t> threshold;
+            std::atomic<uint64_t> calls;
+            std::atomic<uint64_t> slow;
+            
+            size_t capacity;
+            size_t capture;
+            uint32_t rate;
+            
+            std::mutex mutex;
+            std::vector<SlowCall> ring;
+            size_t head;
+        };
+    }
+}
+
+#endif
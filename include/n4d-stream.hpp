@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef EDUPALS_N4D_STREAM
+#define EDUPALS_N4D_STREAM
+
+#include <variant.hpp>
+
+#include <string>
+#include <vector>
+
+namespace edupals
+{
+    namespace n4d
+    {
+        /*!
+         * Receives a value as a stream of events, in document order. Struct
+         * members come as member() followed by events of its value
+        */
+        class Visitor
+        {
+            public:
+            
+            virtual ~Visitor()
+            {
+            }
+            
+            virtual void begin_array()
+            {
+            }
+            
+            virtual void end_array()
+            {
+            }
+            
+            virtual void begin_struct()
+            {
+            }
+            
+            /*!
+             * Name of the struct member whose value comes next
+            */
+            virtual void member(const std::string&)
+            {
+            }
+            
+            virtual void end_struct()
+            {
+            }
+            
+            /*!
+             * Scalar value, None for untyped or unknown values
+            */
+            virtual void value(const variant::Variant&)
+            {
+            }
+        };
+        
+        /*!
+         * Builds a Variant out of visitor events
+        */
+        class Builder: public Visitor
+        {
+            public:
+            
+            /*!
+             * Built value, None until a whole value has been seen
+            */
+            variant::Variant get();
+            
+            void begin_array() override;
+            void end_array() override;
+            void begin_struct() override;
+            void member(const std::string& name) override;
+            void end_struct() override;
+            void value(const variant::Variant& value) override;
+            
+            protected:
+            
+            variant::Variant root;
+            std::vector<variant::Variant> stack;
+            std::vector<std::string> names;
+            
+            void add(variant::Variant value);
+        };
+    }
+}
+
+#endif
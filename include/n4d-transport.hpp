@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef EDUPALS_N4D_TRANSPORT
+#define EDUPALS_N4D_TRANSPORT
+
+#include <n4d.hpp>
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+
+namespace edupals
+{
+    namespace n4d
+    {
+        /*!
+         * A xml-rpc request handed to a Transport
+        */
+        class Message
+        {
+            public:
+            
+            const std::string& address;
+            
+            /*! plugin name and method, informative only */
+            const std::string& name;
+            const std::string& method;
+            
+            const std::string& request;
+            
+            /*! connection timeout in milliseconds */
+            int timeout;
+            
+            /*! network phases are stored here, if not null */
+            Trace* trace;
+            
+            /*! whole transfer limit in milliseconds, 0 for none */
+            int limit;
+        };
+        
+        /*!
+         * Moves request bytes to a server and back. Transports may be shared
+         * among clients and threads
+        */
+        class Transport
+        {
+            public:
+            
+            virtual ~Transport()
+            {
+            }
+            
+            /*!
+             * Posts message request and stores response body. Throws
+             * ServerError on failure
+            */
+            virtual void post(const Message& message,std::string& response) = 0;
+            
+            /*!
+             * Receives response body chunks as they arrive
+            */
+            typedef std::function<void(const char* data,size_t size)> Sink;
+            
+            /*!
+             * Posts message request, handing response body to sink. Default
+             * implementation buffers whole body first
+            */
+            virtual void post(const Message& message,const Sink& sink);
+        };
+        
+        /*!
+         * libcurl based http(s) transport. Addresses in the form
+         * unix:///path/to/socket are reached through an unix socket
+        */
+        class CurlTransport: public Transport
+        {
+            public:
+            
+            /*!
+             * Each request uses a fresh connection
+            */
+            CurlTransport();
+            
+            /*!
+             * Keeps up to connections persistent connections, requests
+             * beyond that wait for a free one
+            */
+            CurlTransport(size_t connections);
+            
+            CurlTransport(const CurlTransport&) = delete;
+            CurlTransport& operator=(const CurlTransport&) = delete;
+            
+            virtual ~CurlTransport();
+            
+            void post(const Message& message,std::string& response) override;
+            
+            void post(const Message& message,const Sink& sink) override;
+            
+            protected:
+            
+            size_t connections;
+            size_t busy;
+            
+            std::mutex mutex;
+            std::condition_variable available;
+            std::vector<void*> idle;
+            
+            void* acquire();
+            void release(void* curl);
+            
+            /*!
+             * Posts to url, through given unix socket if not empty
+            */
+            void perform(const Message& message,const std::string& url,
+                         const std::string& socket,const Sink& sink);
+        };
+        
+        /*!
+         * http transport through a fixed unix socket, address is only used
+         * as request url
+        */
+        class UnixTransport: public CurlTransport
+        {
+            public:
+            
+            UnixTransport(std::string path);
+            
+            void post(const Message& message,std::string& response) override;
+            
+            void post(const Message& message,const Sink& sink) override;
+            
+            protected:
+            
+            std::string path;
+        };
+        
+        /*!
+         * In-process transport, requests are handed straight to a handler
+         * that returns response body
+        */
+        class LoopbackTransport: public Transport
+        {
+            public:
+            
+            typedef std::function<std::string(const std::string&)> Handler;
+            
+            LoopbackTransport(Handler handler);
+            
+            using Transport::post;
+            
+            void post(const Message& message,std::string& response) override;
+            
+            protected:
+            
+            Handler handler;
+        };
+    }
+}
+
+#endif
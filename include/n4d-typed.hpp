@@ -0,0 +1,801 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef EDUPALS_N4D_TYPED
+#define EDUPALS_N4D_TYPED
+
+#include <n4d.hpp>
+#include <variant.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <type_traits>
+#include <functional>
+#include <utility>
+
+namespace edupals
+{
+    namespace n4d
+    {
+        namespace exception
+        {
+            /*!
+             * A decoded value does not match expected type. Path tells
+             * where, like [2].name for member name of third array item
+            */
+            class TypeMismatch: public std::exception
+            {
+                public:
+                
+                std::string path;
+                std::string expected;
+                std::string found;
+                
+                std::string msg;
+                
+                TypeMismatch(std::string expected,std::string found)
+                {
+                    this->expected=expected;
+                    this->found=found;
+                    update();
+                }
+                
+                /*!
+                 * Adds an outer node to path
+                */
+                void prepend(const std::string& node)
+                {
+                    path=node+path;
+                    update();
+                }
+                
+                const char* what() const throw()
+                {
+                    return msg.c_str();
+                }
+                
+                private:
+                
+                void update()
+                {
+                    msg="Type mismatch at return"+path+": expected "+expected+", found "+found;
+                }
+            };
+        }
+        
+        namespace typed
+        {
+            /*!
+             * Read only cursor over a <value> of a response buffer. It is
+             * only valid while the call decoding it runs
+            */
+            class Node
+            {
+                public:
+                
+                Node();
+                
+                explicit Node(void* value,void* member = nullptr);
+                
+                bool valid() const;
+                
+                /*!
+                 * Type as it would be parsed into a Variant
+                */
+                variant::Type type() const;
+                
+                bool get_boolean() const;
+                int32_t get_int32() const;
+                double get_double() const;
+                std::string get_string() const;
+                
+                /*!
+                 * Raw character data of a scalar, pointing into response
+                 * buffer, with entities already translated
+                */
+                const char* data(size_t& size) const;
+                
+                /*!
+                 * First array item or struct member
+                */
+                Node first() const;
+                
+                /*!
+                 * Next array item or struct member
+                */
+                Node next() const;
+                
+                /*!
+                 * Member name, on nodes from struct iteration
+                */
+                std::string name() const;
+                
+                /*!
+                 * Looks up a struct member, returns an invalid node if missing
+                */
+                Node member(const std::string& name) const;
+                
+                variant::Variant to_variant() const;
+                
+                protected:
+                
+                void* value;
+                void* member_node;
+            };
+            
+            /*!
+             * A plugin method with its request header already serialized,
+             * as emitted by n4d-stubgen
+            */
+            class Method
+            {
+                public:
+                
+                const char* name;
+                const char* method;
+                
+                /*! xml declaration, methodName and params opening */
+                const char* prefix;
+                
+                /*! plugin name param */
+                const char* name_param;
+            };
+            
+            /*!
+             * Writes xml-rpc values and reads them back from response nodes
+             * or Variants. Specialize it with static encode and decode
+             * functions to use your own types on typed calls, or derive
+             * from Struct to map struct members
+            */
+            template <typename T,typename Enable = void>
+            class Traits;
+            
+            /*!
+             * Wire encoding helpers, same output as Variant serialization
+            */
+            void encode_string(const std::string& value,std::string& out);
+            void encode_double(double value,std::string& out);
+            void encode_variant(variant::Variant value,std::string& out);
+            
+            /*!
+             * Appends value as xml character data, like member names
+            */
+            void encode_text(const std::string& value,std::string& out);
+            
+            /*!
+             * Appends data as a <base64> value
+            */
+            void encode_base64(const uint8_t* data,size_t size,std::string& out);
+            
+            /*!
+             * Decodes base64 text into out, skipping whitespace. Returns
+             * false on malformed text
+            */
+            bool decode_base64(const char* text,size_t size,std::vector<uint8_t>& out);
+            
+            /*!
+             * Readable name of a value type, for errors
+            */
+            std::string type_name(variant::Variant value);
+            std::string type_name(const Node& node);
+            
+            template <typename T>
+            void encode(const T& value,std::string& out)
+            {
+                Traits<typename std::decay<T>::type>::encode(value,out);
+            }
+            
+            template <typename T>
+            T decode(variant::Variant value)
+            {
+                T ret;
+                Traits<T>::decode(value,ret);
+                
+                return ret;
+            }
+            
+            template <typename T>
+            void param(const T& value,std::string& out)
+            {
+                out+="<param>";
+                encode(value,out);
+                out+="</param>";
+            }
+            
+            template <>
+            class Traits<bool>
+            {
+                public:
+                
+                static void encode(bool value,std::string& out)
+                {
+                    out+=value ? "<value><boolean>1</boolean></value>" : "<value><boolean>0</boolean></value>";
+                }
+                
+                static void decode(variant::Variant value,bool& out)
+                {
+                    if (value.type()!=variant::Type::Boolean) {
+                        throw exception::TypeMismatch("boolean",type_name(value));
+                    }
+                    
+                    out=value.get_boolean();
+                }
+                
+                static void decode(const Node& node,bool& out)
+                {
+                    if (node.type()!=variant::Type::Boolean) {
+                        throw exception::TypeMismatch("boolean",type_name(node));
+                    }
+                    
+                    out=node.get_boolean();
+                }
+            };
+            
+            template <>
+            class Traits<int32_t>
+            {
+                public:
+                
+                static void encode(int32_t value,std::string& out)
+                {
+                    out+="<value><int>";
+                    out+=std::to_string(value);
+                    out+="</int></value>";
+                }
+                
+                static void decode(variant::Variant value,int32_t& out)
+                {
+                    if (value.type()!=variant::Type::Int32) {
+                        throw exception::TypeMismatch("int",type_name(value));
+                    }
+                    
+                    out=value.get_int32();
+                }
+                
+                static void decode(const Node& node,int32_t& out)
+                {
+                    if (node.type()!=variant::Type::Int32) {
+                        throw exception::TypeMismatch("int",type_name(node));
+                    }
+                    
+                    out=node.get_int32();
+                }
+            };
+            
+            template <>
+            class Traits<double>
+            {
+                public:
+                
+                static void encode(double value,std::string& out)
+                {
+                    encode_double(value,out);
+                }
+                
+                /*!
+                 * ints are widened
+                */
+                static void decode(variant::Variant value,double& out)
+                {
+                    switch (value.type()) {
+                        case variant::Type::Double:
+                            out=value.get_double();
+                        break;
+                        
+                        case variant::Type::Float:
+                            out=value.get_float();
+                        break;
+                        
+                        case variant::Type::Int32:
+                            out=value.get_int32();
+                        break;
+                        
+                        default:
+                            throw exception::TypeMismatch("double",type_name(value));
+                    }
+                }
+                
+                static void decode(const Node& node,double& out)
+                {
+                    switch (node.type()) {
+                        case variant::Type::Double:
+                            out=node.get_double();
+                        break;
+                        
+                        case variant::Type::Int32:
+                            out=node.get_int32();
+                        break;
+                        
+                        default:
+                            throw exception::TypeMismatch("double",type_name(node));
+                    }
+                }
+            };
+            
+            template <>
+            class Traits<std::string>
+            {
+                public:
+                
+                static void encode(const std::string& value,std::string& out)
+                {
+                    encode_string(value,out);
+                }
+                
+                static void decode(variant::Variant value,std::string& out)
+                {
+                    if (value.type()!=variant::Type::String) {
+                        throw exception::TypeMismatch("string",type_name(value));
+                    }
+                    
+                    out=value.get_string();
+                }
+                
+                static void decode(const Node& node,std::string& out)
+                {
+                    if (node.type()!=variant::Type::String) {
+                        throw exception::TypeMismatch("string",type_name(node));
+                    }
+                    
+                    out=node.get_string();
+                }
+            };
+            
+            /*!
+             * String literals, only as arguments
+            */
+            template <>
+            class Traits<const char*>
+            {
+                public:
+                
+                static void encode(const char* value,std::string& out)
+                {
+                    encode_string(value,out);
+                }
+            };
+            
+            template <>
+            class Traits<char*> : public Traits<const char*>
+            {
+            };
+            
+            template <>
+            class Traits<variant::Variant>
+            {
+                public:
+                
+                static void encode(const variant::Variant& value,std::string& out)
+                {
+                    encode_variant(value,out);
+                }
+                
+                static void decode(variant::Variant value,variant::Variant& out)
+                {
+                    out=value;
+                }
+                
+                static void decode(const Node& node,variant::Variant& out)
+                {
+                    out=node.to_variant();
+                }
+            };
+            
+            /*!
+             * Binary payloads, as <base64> values. Plain strings are
+             * accepted on decoding, as servers may send either
+            */
+            template <>
+            class Traits<std::vector<uint8_t> >
+            {
+                public:
+                
+                static void encode(const std::vector<uint8_t>& value,std::string& out)
+                {
+                    encode_base64(value.data(),value.size(),out);
+                }
+                
+                static void decode(variant::Variant value,std::vector<uint8_t>& out)
+                {
+                    if (value.type()!=variant::Type::String) {
+                        throw exception::TypeMismatch("base64",type_name(value));
+                    }
+                    
+                    const std::string& text=value.get_string();
+                    
+                    if (!decode_base64(text.c_str(),text.size(),out)) {
+                        throw exception::TypeMismatch("base64","string");
+                    }
+                }
+                
+                static void decode(const Node& node,std::vector<uint8_t>& out)
+                {
+                    if (node.type()!=variant::Type::String) {
+                        throw exception::TypeMismatch("base64",type_name(node));
+                    }
+                    
+                    size_t size=0;
+                    const char* text=node.data(size);
+                    
+                    if (!decode_base64(text,size,out)) {
+                        throw exception::TypeMismatch("base64","string");
+                    }
+                }
+            };
+            
+            template <typename T>
+            class Traits<std::vector<T> >
+            {
+                public:
+                
+                static void encode(const std::vector<T>& value,std::string& out)
+                {
+                    out+="<value><array><data>";
+                    
+                    for (const T& item : value) {
+                        typed::encode(item,out);
+                    }
+                    
+                    out+="</data></array></value>";
+                }
+                
+                static void decode(variant::Variant value,std::vector<T>& out)
+                {
+                    if (value.type()!=variant::Type::Array) {
+                        throw exception::TypeMismatch("array",type_name(value));
+                    }
+                    
+                    size_t count=value.count();
+                    out.resize(count);
+                    
+                    for (size_t n=0;n<count;n++) {
+                        try {
+                            Traits<T>::decode(value[n],out[n]);
+                        }
+                        catch (exception::TypeMismatch& e) {
+                            e.prepend("["+std::to_string(n)+"]");
+                            throw;
+                        }
+                    }
+                }
+                
+                static void decode(const Node& node,std::vector<T>& out)
+                {
+                    if (node.type()!=variant::Type::Array) {
+                        throw exception::TypeMismatch("array",type_name(node));
+                    }
+                    
+                    out.clear();
+                    size_t n=0;
+                    
+                    for (Node item=node.first();item.valid();item=item.next()) {
+                        out.emplace_back();
+                        
+                        try {
+                            Traits<T>::decode(item,out.back());
+                        }
+                        catch (exception::TypeMismatch& e) {
+                            e.prepend("["+std::to_string(n)+"]");
+                            throw;
+                        }
+                        
+                        n++;
+                    }
+                }
+            };
+            
+            template <typename T>
+            class Traits<std::map<std::string,T> >
+            {
+                public:
+                
+                static void encode(const std::map<std::string,T>& value,std::string& out)
+                {
+                    out+="<value><struct>";
+                    
+                    for (auto& member : value) {
+                        out+="<member><name>";
+                        encode_text(member.first,out);
+                        out+="</name>";
+                        typed::encode(member.second,out);
+                        out+="</member>";
+                    }
+                    
+                    out+="</struct></value>";
+                }
+                
+                static void decode(variant::Variant value,std::map<std::string,T>& out)
+                {
+                    if (value.type()!=variant::Type::Struct) {
+                        throw exception::TypeMismatch("struct",type_name(value));
+                    }
+                    
+                    out.clear();
+                    
+                    for (std::string& key : value.keys()) {
+                        try {
+                            Traits<T>::decode(value[key],out[key]);
+                        }
+                        catch (exception::TypeMismatch& e) {
+                            e.prepend("."+key);
+                            throw;
+                        }
+                    }
+                }
+                
+                static void decode(const Node& node,std::map<std::string,T>& out)
+                {
+                    if (node.type()!=variant::Type::Struct) {
+                        throw exception::TypeMismatch("struct",type_name(node));
+                    }
+                    
+                    out.clear();
+                    
+                    for (Node member=node.first();member.valid();member=member.next()) {
+                        std::string key=member.name();
+                        
+                        try {
+                            Traits<T>::decode(member,out[key]);
+                        }
+                        catch (exception::TypeMismatch& e) {
+                            e.prepend("."+key);
+                            throw;
+                        }
+                    }
+                }
+            };
+            
+            /*!
+             * Member mapping of a user struct
+            */
+            template <typename T>
+            class Fields
+            {
+                public:
+                
+                class Field
+                {
+                    public:
+                    
+                    std::string name;
+                    std::function<void(const T&,std::string&)> encode;
+                    std::function<void(const Node&,T&)> decode;
+                    std::function<void(variant::Variant,T&)> decode_variant;
+                };
+                
+                std::vector<Field> fields;
+                
+                /*!
+                 * Maps struct member name to object member
+                */
+                template <typename F>
+                void add(const std::string& name,F T::* member)
+                {
+                    Field field;
+                    
+                    field.name=name;
+                    
+                    field.encode=[member](const T& object,std::string& out) {
+                        typed::encode(object.*member,out);
+                    };
+                    
+                    field.decode=[member](const Node& node,T& object) {
+                        Traits<F>::decode(node,object.*member);
+                    };
+                    
+                    field.decode_variant=[member](variant::Variant value,T& object) {
+                        Traits<F>::decode(value,object.*member);
+                    };
+                    
+                    fields.push_back(field);
+                }
+                
+                const Field* find(const std::string& name) const
+                {
+                    for (const Field& field : fields) {
+                        if (field.name==name) {
+                            return &field;
+                        }
+                    }
+                    
+                    return nullptr;
+                }
+            };
+            
+            /*!
+             * Traits base for user structs, which only have to provide
+             * static void fields(Fields<T>& fields). Unknown members are
+             * ignored and missing ones keep their value
+            */
+            template <typename T>
+            class Struct
+            {
+                public:
+                
+                static const Fields<T>& mapping()
+                {
+                    static const Fields<T> fields=build();
+                    
+                    return fields;
+                }
+                
+                static void encode(const T& value,std::string& out)
+                {
+                    out+="<value><struct>";
+                    
+                    for (auto& field : mapping().fields) {
+                        out+="<member><name>";
+                        encode_text(field.name,out);
+                        out+="</name>";
+                        field.encode(value,out);
+                        out+="</member>";
+                    }
+                    
+                    out+="</struct></value>";
+                }
+                
+                static void decode(const Node& node,T& out)
+                {
+                    if (node.type()!=variant::Type::Struct) {
+                        throw exception::TypeMismatch("struct",type_name(node));
+                    }
+                    
+                    const Fields<T>& fields=mapping();
+                    
+                    for (Node member=node.first();member.valid();member=member.next()) {
+                        std::string key=member.name();
+                        const typename Fields<T>::Field* field=fields.find(key);
+                        
+                        if (!field) {
+                            continue;
+                        }
+                        
+                        try {
+                            field->decode(member,out);
+                        }
+                        catch (exception::TypeMismatch& e) {
+                            e.prepend("."+key);
+                            throw;
+                        }
+                    }
+                }
+                
+                static void decode(variant::Variant value,T& out)
+                {
+                    if (value.type()!=variant::Type::Struct) {
+                        throw exception::TypeMismatch("struct",type_name(value));
+                    }
+                    
+                    const Fields<T>& fields=mapping();
+                    
+                    for (std::string& key : value.keys()) {
+                        const typename Fields<T>::Field* field=fields.find(key);
+                        
+                        if (!field) {
+                            continue;
+                        }
+                        
+                        try {
+                            field->decode_variant(value[key],out);
+                        }
+                        catch (exception::TypeMismatch& e) {
+                            e.prepend("."+key);
+                            throw;
+                        }
+                    }
+                }
+                
+                protected:
+                
+                static Fields<T> build()
+                {
+                    Fields<T> fields;
+                    Traits<T>::fields(fields);
+                    
+                    return fields;
+                }
+            };
+            
+            /*!
+             * Holds call result, void discards it
+            */
+            template <typename R>
+            class Result
+            {
+                public:
+                
+                R value;
+                
+                void decode(const Node& node)
+                {
+                    Traits<R>::decode(node,value);
+                }
+                
+                R get()
+                {
+                    return std::move(value);
+                }
+            };
+            
+            template <>
+            class Result<void>
+            {
+                public:
+                
+                void decode(const Node&)
+                {
+                }
+                
+                void get()
+                {
+                }
+            };
+        }
+        
+        template <typename R,typename... Args>
+        R Client::call(const std::string& name,const std::string& method,const Args&... args)
+        {
+            typed::Result<R> result;
+            
+            invoke(name,method,[&](std::string& request) {
+                begin_call(name,method,request);
+                
+                // one <param> per argument, in order
+                int expand[]={0,(typed::param(args,request),0)...};
+                (void)expand;
+                
+                request+="</params></methodCall>";
+            },[&](const typed::Node& node) {
+                result.decode(node);
+            });
+            
+            return result.get();
+        }
+        
+        template <typename R,typename... Args>
+        R Client::call(const typed::Method& method,const Args&... args)
+        {
+            typed::Result<R> result;
+            
+            invoke(method.name,method.method,[&](std::string& request) {
+                begin_call(method,request);
+                
+                int expand[]={0,(typed::param(args,request),0)...};
+                (void)expand;
+                
+                request+="</params></methodCall>";
+            },[&](const typed::Node& node) {
+                result.decode(node);
+            });
+            
+            return result.get();
+        }
+    }
+}
+
+// View over n4d::typed::Node
+#include <n4d-view.hpp>
+
+#endif
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef EDUPALS_N4D_VIEW
+#define EDUPALS_N4D_VIEW
+
+#include <n4d-typed.hpp>
+#include <variant.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace edupals
+{
+    namespace n4d
+    {
+        /*!
+         * Read only view over a value of a parsed response. Buffer is
+         * indexed once and subtrees are only turned into values when
+         * accessed. Views share the response, which stays alive as long
+         * as any view into it does
+        */
+        class View
+        {
+            public:
+            
+            /*!
+             * Empty view, of type None
+            */
+            View();
+            
+            /*!
+             * Takes a xml-rpc methodResponse and views its param. Throws
+             * ServerError on malformed responses
+            */
+            explicit View(std::string incoming);
+            
+            /*!
+             * Views an already built value
+            */
+            explicit View(variant::Variant value);
+            
+            /*!
+             * Type as it would be parsed into a Variant
+            */
+            variant::Type type() const;
+            
+            bool none() const;
+            
+            /*!
+             * Array items or struct members, 0 otherwise
+            */
+            size_t count() const;
+            
+            /*!
+             * Array item, or an empty view if out of range. Items are
+             * reached walking the array, iterate with first() and next()
+             * for sequential access
+            */
+            View operator[](size_t index) const;
+            
+            /*!
+             * Struct member, or an empty view if missing
+            */
+            View operator[](const std::string& name) const;
+            
+            /*!
+             * First array item or struct member
+            */
+            View first() const;
+            
+            /*!
+             * Next array item or struct member
+            */
+            View next() const;
+            
+            /*!
+             * Member name, on views from struct iteration
+            */
+            std::string name() const;
+            
+            /*!
+             * Struct member names
+            */
+            std::vector<std::string> keys() const;
+            
+            /*!
+             * Scalar getters, throwing exception::TypeMismatch on other types
+            */
+            bool get_boolean() const;
+            int32_t get_int32() const;
+            double get_double() const;
+            std::string get_string() const;
+            
+            /*!
+             * Decodes viewed value as T, see n4d-typed.hpp
+            */
+            template <typename T>
+            T get() const
+            {
+                T out;
+                typed::Traits<T>::decode(value,out);
+                
+                return out;
+            }
+            
+            /*!
+             * Builds viewed subtree
+            */
+            variant::Variant to_variant() const;
+            
+            /*!
+             * Underlying cursor, valid while this view lives
+            */
+            const typed::Node& node() const;
+            
+            protected:
+            
+            class Document;
+            
+            View(std::shared_ptr<Document> document,typed::Node value);
+            
+            std::shared_ptr<Document> document;
+            typed::Node value;
+        };
+    }
+}
+
+#endif
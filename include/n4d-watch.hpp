@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef EDUPALS_N4D_WATCH
+#define EDUPALS_N4D_WATCH
+
+#include <n4d.hpp>
+#include <variant.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <memory>
+#include <cstdint>
+
+namespace edupals
+{
+    namespace n4d
+    {
+        /*!
+         * Called with name and new value of a changed variable, value
+         * is none when variable has been deleted
+        */
+        typedef std::function<void(const std::string&,variant::Variant)> WatchCallback;
+        
+        /*!
+         * Watches variables for changes from a worker thread, callbacks
+         * run there. Servers answering wait_changes(serial,timeout) are
+         * long-polled, otherwise all watched names are read in one request
+         * per interval, going from min_interval up to max_interval
+         * milliseconds while nothing changes
+        */
+        class Watcher
+        {
+            public:
+            
+            Watcher(Client client,int min_interval = 250,int max_interval = 8000);
+            
+            Watcher(const Watcher&) = delete;
+            Watcher& operator=(const Watcher&) = delete;
+            
+            /*!
+             * Stops watching, may wait for a pending long-poll
+            */
+            virtual ~Watcher();
+            
+            /*!
+             * Starts watching names, callback is only called on changes
+             * made after this call. Current values are read here, or by
+             * worker when server is unreachable
+             * \returns id to be used on unwatch
+            */
+            int watch(std::vector<std::string> names,WatchCallback callback);
+            
+            void unwatch(int id);
+            
+            /*!
+             * Sets how long a long-poll waits on server, in milliseconds
+            */
+            void set_poll_timeout(int ms);
+            
+            /*!
+             * Whenever server supports long-poll, known after first sync
+            */
+            bool long_poll();
+            
+            protected:
+            
+            enum class Mode
+            {
+                Unknown,
+                LongPoll,
+                Polling
+            };
+            
+            class Watch
+            {
+                public:
+                
+                std::vector<std::string> names;
+                WatchCallback callback;
+            };
+            
+            class Poller;
+            
+            Client client;
+            
+            /*! client transport, bounding long-polls */
+            std::shared_ptr<Poller> poller;
+            
+            int min_interval;
+            int max_interval;
+            int poll_timeout;
+            
+            std::mutex mutex;
+            std::condition_variable wake;
+            bool running;
+            
+            std::map<int,Watch> watches;
+            int next_id;
+            
+            /*! digest of last seen value, 0 when missing, guarded by mutex */
+            std::map<std::string,uint64_t> seen;
+            
+            Mode mode;
+            int64_t serial;
+            
+            std::thread worker;
+            
+            void worker_loop();
+            
+            /*!
+             * Waits for changes on server
+             * \returns false if server lacks wait_changes
+            */
+            bool wait_changes(std::map<std::string,variant::Variant>& values,std::vector<std::string>& deleted);
+            
+            void read_all(std::map<std::string,variant::Variant>& values,std::vector<std::string>& deleted);
+            
+            /*!
+             * Updates seen values and runs callbacks of changed ones
+             * \returns number of changes
+            */
+            size_t dispatch(std::map<std::string,variant::Variant>& values,std::vector<std::string>& deleted);
+            
+            /*!
+             * Takes current values of names not seen yet
+            */
+            void seed(const std::vector<std::string>& names);
+            
+            std::vector<std::string> names();
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef EDUPALS_N4D_WRITEBEHIND
+#define EDUPALS_N4D_WRITEBEHIND
+
+#include <n4d.hpp>
+#include <variant.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <exception>
+
+namespace edupals
+{
+    namespace n4d
+    {
+        /*!
+         * Receives variable write errors found on background flushes
+        */
+        typedef std::function<void(const std::string&,std::exception_ptr)> WriteErrorHandler;
+        
+        /*!
+         * Queue of pending variable writes. Later writes to the same
+         * variable replace earlier ones, queue is flushed when it reaches
+         * max_pending writes, every interval milliseconds or on demand.
+         * Each flush is sent as a single system.multicall when server
+         * supports it. Writes are sent through its own copy of the client,
+         * see set_sender
+        */
+        class WriteBehind
+        {
+            public:
+            
+            enum class Type
+            {
+                Set,
+                Delete
+            };
+            
+            class Write
+            {
+                public:
+                
+                Type type;
+                variant::Variant value;
+                variant::Variant attribs;
+            };
+            
+            WriteBehind(Client sender,size_t max_pending,int interval);
+            
+            WriteBehind(const WriteBehind&) = delete;
+            WriteBehind& operator=(const WriteBehind&) = delete;
+            
+            /*!
+             * Flushes pending writes
+            */
+            virtual ~WriteBehind();
+            
+            void push(std::string name,Write write);
+            
+            /*!
+             * Looks for a pending write of a variable
+            */
+            bool find(const std::string& name,Write& write);
+            
+            /*!
+             * Gets pending writes, in order
+            */
+            std::vector<std::pair<std::string,Write> > pending();
+            
+            /*!
+             * Sends pending writes.
+             * \returns failed variables, including the ones from previous
+             * background flushes not delivered to an error handler
+            */
+            std::map<std::string,std::exception_ptr> flush();
+            
+            /*!
+             * Replaces the client used to send writes, including queued
+             * ones. Waits for a flush in progress
+            */
+            void set_sender(Client sender);
+            
+            void set_error_handler(WriteErrorHandler handler);
+            
+            protected:
+            
+            Client sender;
+            size_t max_pending;
+            int interval;
+            
+            std::mutex mutex;
+            std::condition_variable wake;
+            bool running;
+            std::thread worker;
+            
+            /*! queued writes, order keeps first write time of each variable */
+            std::vector<std::string> order;
+            std::map<std::string,Write> writes;
+            
+            /*! writes being sent, still visible to readers */
+            std::map<std::string,Write> flushing;
+            
+            std::mutex flush_mutex;
+            std::map<std::string,std::exception_ptr> failed;
+            WriteErrorHandler handler;
+            
+            void worker_loop();
+            
+            /*!
+             * Sends a single write, recording its error
+            */
+            void send(const std::string& name,const Write& write);
+            
+            /*!
+             * Sends writes in one system.multicall, recording errors of each
+             * one. Returns false if multicall faulted, nothing was sent then
+            */
+            bool send_batch(const std::vector<std::string>& names,const std::vector<Write>& batch);
+            
+            /*!
+             * Drops names from sender shared cache, if any
+            */
+            void invalidate(const std::vector<std::string>& names);
+        };
+    }
+}
+
+#endif
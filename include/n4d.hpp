@@ -31,6 +31,10 @@
 #include <vector>
 #include <map>
 #include <exception>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <cstdint>
 
 #define EDUPALS_N4D_DEFAULT_URL "https://127.0.0.1:9779"
 #define EDUPALS_N4D_DEFAULT_TIMEOUT 5000
@@ -263,6 +267,40 @@ namespace edupals
                 
             };
             
+            /*!
+             * xml-rpc fault response, code is always 0
+            */
+            class Fault : public ServerError
+            {
+                public:
+                
+                int32_t fault_code;
+                std::string fault_string;
+                
+                Fault(int32_t fault_code,std::string fault_string) :
+                    ServerError(0,"xml-rpc: fault "+std::to_string(fault_code)+" "+fault_string)
+                {
+                    this->fault_code=fault_code;
+                    this->fault_string=fault_string;
+                }
+                
+                /*!
+                 * Whenever fault says method is not available on server
+                */
+                bool missing(const std::string& method) const
+                {
+                    if (fault_string.find(method)==std::string::npos) {
+                        return false;
+                    }
+                    
+                    return (fault_string.find("not supported")!=std::string::npos or
+                            fault_string.find("not found")!=std::string::npos or
+                            fault_string.find("not exist")!=std::string::npos or
+                            fault_string.find("unknown")!=std::string::npos or
+                            fault_string.find("Unknown")!=std::string::npos);
+                }
+            };
+            
             class InvalidCredential : public std::exception
             {
                 public:
@@ -560,6 +598,91 @@ namespace edupals
             
         };
         
+        /*!
+         * Timing and size record of a single call. Times are expressed in
+         * microseconds, network phases are taken from curl
+        */
+        class Trace
+        {
+            public:
+            
+            /*! plugin name, N4D for builtin calls and empty for raw rpc calls */
+            std::string name;
+            std::string method;
+            
+            /*! false when call has thrown any exception */
+            bool success;
+            
+            /*! N4D status code from response, see ErrorCode */
+            int status;
+            
+            /*! curl error code on transport failures */
+            int curl_code;
+            
+            /*! response was shared from an identical call in flight */
+            bool coalesced;
+            
+            int64_t serialize;
+            int64_t dns;
+            int64_t connect;
+            int64_t tls;
+            
+            /*! from request sent to first response byte */
+            int64_t ttfb;
+            int64_t transfer;
+            int64_t parse;
+            int64_t validate;
+            int64_t total;
+            
+            size_t request_size;
+            size_t response_size;
+            
+            /*! max request bytes to keep, none by default */
+            size_t capture;
+            
+            /*! truncated request body, only filled when capture is set */
+            std::string request;
+            
+            Trace() : success(false), status(ErrorCode::CallSuccessful), curl_code(0), coalesced(false),
+                      serialize(0), dns(0), connect(0), tls(0),
+                      ttfb(0), transfer(0), parse(0), validate(0), total(0),
+                      request_size(0), response_size(0), capture(0)
+            {
+            }
+        };
+        
+        typedef std::function<void(const Trace&)> TraceSink;
+        
+        class Metrics;
+        class SlowLog;
+        class Transport;
+        class Coalescer;
+        class WriteBehind;
+        class SharedCache;
+        class View;
+        class Visitor;
+        
+        namespace typed
+        {
+            class Node;
+            class Method;
+        }
+        
+        namespace xmlrpc
+        {
+            class Interner;
+        }
+        
+        /*!
+         * Scope of decoded scalar sharing, see Client::set_interning
+        */
+        enum class Interning
+        {
+            None,
+            Call,
+            Client
+        };
+        
         enum Option
         {
             None = 0x00,
@@ -569,6 +692,9 @@ namespace edupals
         
         class Client
         {
+            /*! sends queued writes through client internals */
+            friend class WriteBehind;
+            
             protected:
             int flags;
             int timeout;
@@ -577,8 +703,35 @@ namespace edupals
             
             auth::Credential credential;
             
+            TraceSink trace_sink;
+            std::shared_ptr<Metrics> metrics;
+            std::shared_ptr<SlowLog> slow_log;
+            
+            std::shared_ptr<Transport> transport;
+            std::shared_ptr<Coalescer> coalescer;
+            std::shared_ptr<WriteBehind> write_behind;
+            
+            std::shared_ptr<SharedCache> shared_cache;
+            int cache_age = 0;
+            
+            /*! parallel response decoding, see set_parallel_decoding */
+            size_t decode_threshold = 0;
+            size_t decode_threads = 0;
+            
+            Interning interning = Interning::None;
+            std::shared_ptr<xmlrpc::Interner> interner;
+            
+            /*!
+             * whenever server is expected to support system.multicall,
+             * shared by copies of this client and reset by set_address
+            */
+            std::shared_ptr<std::atomic<bool> > multicall = std::make_shared<std::atomic<bool> >(true);
+            
             void post(std::stringstream& in,std::stringstream& out);
             
+            /*! passes current settings to write queue sender */
+            void update_write_behind();
+            
             void create_value(variant::Variant param,std::stringstream& out);
 
             void create_request(std::string method,
@@ -591,6 +744,102 @@ namespace edupals
             
             void handle_variable_error(VariableErrorCode code, std::string name);
             
+            /*!
+             * Whenever calls have to be timed
+            */
+            bool tracing();
+            
+            /*!
+             * Notifies a call is about to start
+            */
+            void trace_started(Trace& trace);
+            
+            /*!
+             * Delivers a finished trace record
+            */
+            void trace_finished(Trace& trace);
+            
+            /*!
+             * Raw xml-rpc call on behalf of plugin name, filling given trace if any
+            */
+            variant::Variant rpc_call(const std::string& name,std::string method,
+                                      std::vector<variant::Variant>& params,Trace* trace);
+            
+            /*!
+             * Writes a xml-rpc request into given string
+            */
+            typedef std::function<void(std::string&)> Serializer;
+            
+            /*!
+             * Serializes and sends a request, filling given trace if any
+            */
+            variant::Variant send(const std::string& name,const std::string& method,
+                                  const Serializer& serialize,Trace* trace);
+            
+            /*!
+             * Serializes and sends a request, leaving raw response
+            */
+            void send(const std::string& name,const std::string& method,
+                      const Serializer& serialize,Trace* trace,std::string& incoming);
+            
+            /*!
+             * Posts a serialized request through transport
+            */
+            void transfer(const std::string& name,const std::string& method,
+                          const std::string& request,Trace* trace,std::string& incoming);
+            
+            /*!
+             * Parses a xml-rpc methodResponse
+            */
+            variant::Variant parse_response(const std::string& incoming);
+            
+            /*!
+             * Performs a rpc call and validates its N4D response
+            */
+            variant::Variant invoke(std::string name,std::string method,std::vector<variant::Variant>& params);
+            
+            variant::Variant invoke(const std::string& name,const std::string& method,const Serializer& serialize);
+            
+            /*!
+             * Receives return value of a successful call
+            */
+            typedef std::function<void(const typed::Node&)> Decoder;
+            
+            /*!
+             * Performs a rpc call and decodes its return value straight
+             * from response, failed calls are validated as usual
+            */
+            void invoke(const std::string& name,const std::string& method,
+                        const Serializer& serialize,const Decoder& decode);
+            
+            /*!
+             * Receives a view over return value of a successful call
+            */
+            typedef std::function<void(const View&)> Viewer;
+            
+            void invoke(const std::string& name,const std::string& method,
+                        const Serializer& serialize,const Viewer& view);
+            
+            /*!
+             * Writes N4D call header up to plugin name param, left open
+             * for method params
+            */
+            void begin_call(const std::string& name,const std::string& method,std::string& request);
+            
+            void begin_call(const typed::Method& method,std::string& request);
+            
+            /*!
+             * Performs a rpc call streaming its return value into visitor,
+             * rest of response is validated as usual
+            */
+            void stream(const std::string& name,const std::string& method,
+                        const Serializer& serialize,Visitor& visitor);
+            
+            /*!
+             * N4D built in call returning a view over its return value
+            */
+            View builtin_view(const std::string& method,std::vector<variant::Variant> params);
+            
             public:
             
             /*!
@@ -655,11 +904,46 @@ namespace edupals
             [[deprecated("credential argument will be ignored!")]]
             variant::Variant call(std::string name,std::string method,std::vector<variant::Variant> params, auth::Credential credential);
             
+            /*!
+             * Typed n4d call to Plugin.method. Arguments are serialized
+             * straight into the request and result is decoded into R,
+             * see n4d-typed.hpp for supported types
+            */
+            template <typename R,typename... Args>
+            R call(const std::string& name,const std::string& method,const Args&... args);
+            
+            /*!
+             * Typed call through a prepared method, see n4d-stubgen
+            */
+            template <typename R,typename... Args>
+            R call(const typed::Method& method,const Args&... args);
+            
+            /*!
+             * Performs a call returning a lazy view over its return value,
+             * only accessed parts of it are ever decoded
+            */
+            View call_view(const std::string& name,const std::string& method,
+                           const std::vector<variant::Variant>& params = {});
+            
+            /*!
+             * Streams return value of a call into visitor while it is being
+             * downloaded, so it is never held whole. Visitor may have seen
+             * part of the value of a call that fails afterwards
+            */
+            void call(const std::string& name,const std::string& method,
+                      const std::vector<variant::Variant>& params,Visitor& visitor);
+            
             /*!
              * Performs a N4D built in call: with no plugin name and no credential
             */
             variant::Variant builtin_call(std::string method,std::vector<variant::Variant> params);
             
+            /*!
+             * Streamed N4D built in call, see call() with a visitor
+            */
+            void builtin_call(const std::string& method,const std::vector<variant::Variant>& params,
+                              Visitor& visitor);
+            
             virtual ~Client();
             
             /*!
@@ -725,6 +1009,37 @@ namespace edupals
             */
             variant::Variant get_variables(bool attribs=false);
             
+            /*!
+                Gets a set of variables in one round trip, as a struct keyed
+                by name. Not found names are left out
+            */
+            variant::Variant get_variables(const std::vector<std::string>& names,bool attribs=false);
+            
+            /*!
+                Gets a set of variables in one round trip, not found names
+                are appended to missing. Throws first error of a single
+                variable, if any
+            */
+            variant::Variant get_variables(const std::vector<std::string>& names,bool attribs,
+                                           std::vector<std::string>& missing);
+            
+            /*!
+                Same as above, but errors of single variables are stored
+                into failed by name instead of thrown, so the rest are
+                still returned
+            */
+            variant::Variant get_variables(const std::vector<std::string>& names,bool attribs,
+                                           std::vector<std::string>& missing,
+                                           std::map<std::string,std::exception_ptr>& failed);
+            
+            /*!
+                Lazy forms of get_variable and get_variables, for reading
+                a few fields out of large values
+            */
+            View get_variable_view(const std::string& name,bool attribs = false);
+            
+            View get_variables_view(bool attribs = false);
+            
             /*!
                 Checks for a variable
             */
@@ -780,8 +1095,112 @@ namespace edupals
              *  Sets timeout in milliseconds
              */
             void set_timeout(int ms);
+            
+            /*!
+             * Sets a function that receives a Trace record after every call.
+             * An empty function disables tracing
+            */
+            void set_trace_sink(TraceSink sink);
+            
+            /*!
+             * Sets a metrics registry to be updated on every call. The same
+             * registry may be shared among several clients
+            */
+            void set_metrics(std::shared_ptr<Metrics> metrics);
+            
+            /*!
+             * Gets current metrics registry, if any
+            */
+            std::shared_ptr<Metrics> get_metrics();
+            
+            /*!
+             * Sets a log where calls over its threshold are kept
+            */
+            void set_slow_log(std::shared_ptr<SlowLog> slow_log);
+            
+            /*!
+             * Gets current slow call log, if any
+            */
+            std::shared_ptr<SlowLog> get_slow_log();
+            
+            /*!
+             * Sets the transport used to reach the server, a curl based one
+             * is used by default
+            */
+            void set_transport(std::shared_ptr<Transport> transport);
+            
+            /*!
+             * Gets current transport
+            */
+            std::shared_ptr<Transport> get_transport();
+            
+            /*!
+             * Enables coalescing of identical idempotent calls in flight,
+             * an empty pointer disables it
+            */
+            void set_coalescer(std::shared_ptr<Coalescer> coalescer);
+            
+            /*!
+             * Gets current coalescer, if any
+            */
+            std::shared_ptr<Coalescer> get_coalescer();
+            
+            /*!
+             * Queues set_variable and delete_variable calls instead of
+             * sending them. Writes to the same variable are collapsed and
+             * sent once max_pending variables are queued, every interval
+             * milliseconds (0 disables the timer) or on flush.
+             * Reads from this client see pending writes.
+             * Writes are sent through a copy of this client, updated
+             * whenever a setting of this client changes.
+             * A max_pending of 0 flushes and disables it
+            */
+            void set_write_behind(size_t max_pending,int interval);
+            
+            /*!
+             * Gets current write queue, if any
+            */
+            std::shared_ptr<WriteBehind> get_write_behind();
+            
+            /*!
+             * Sends pending variable writes
+             * \returns exceptions of failed variables, by name
+            */
+            std::map<std::string,std::exception_ptr> flush();
+            
+            /*!
+             * Serves get_variable and variable_exists from a host shared
+             * cache when its entry is younger than max_age milliseconds,
+             * going to server otherwise. An empty pointer disables it
+            */
+            void set_shared_cache(std::shared_ptr<SharedCache> cache,int max_age = 5000);
+            
+            /*!
+             * Gets current shared cache, if any
+            */
+            std::shared_ptr<SharedCache> get_shared_cache();
+            
+            /*!
+             * Decodes arrays and structs of at least threshold items
+             * concurrently on given threads, all cores when 0. Items are
+             * split once the response is indexed and assembled in order.
+             * A threshold of 0 disables it
+            */
+            void set_parallel_decoding(size_t threshold,size_t threads = 0);
+            
+            /*!
+             * Shares repeated scalars of decoded responses, like member
+             * flags or short strings, among Variants. With Call scope each
+             * response is deduplicated on its own, with Client scope a
+             * table lives across responses so cached values share them too.
+             * Shared strings must not be modified in place
+            */
+            void set_interning(Interning scope);
         };
     }
 }
 
+// Client::call<R> definition
+#include <n4d-typed.hpp>
+
 #endif
@@ -0,0 +1,580 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d.hpp>
+#include <n4d-transport.hpp>
+#include <n4d-typed.hpp>
+#include <n4d-view.hpp>
+#include <n4d-stream.hpp>
+#include <variant.hpp>
+
+#include "kernel.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <new>
+#include <cstdlib>
+
+using namespace edupals;
+using namespace edupals::variant;
+using namespace std;
+
+/*
+    Every allocation made by the process, libraries included, goes through
+    these operators so we can report allocations per operation
+*/
+static std::atomic<uint64_t> allocations(0);
+
+void* operator new(size_t size)
+{
+    allocations.fetch_add(1,std::memory_order_relaxed);
+    void* ptr=std::malloc(size ? size : 1);
+    
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr,size_t) noexcept
+{
+    std::free(ptr);
+}
+
+typedef std::chrono::steady_clock Clock;
+
+/*
+    Exposes Client serialization and parsing stages
+*/
+class BenchClient: public n4d::Client
+{
+    public:
+    
+    using Client::create_value;
+    using Client::create_request;
+    using Client::parse_response;
+    using Client::validate_format;
+    using Client::validate;
+    using Client::begin_call;
+};
+
+/*
+    Typed form of create_variable()
+*/
+class BenchVariable
+{
+    public:
+    
+    string value;
+    string description;
+    bool is_volatile;
+    bool force_update;
+    vector<string> inheritance;
+    double timestamp;
+    int32_t id;
+};
+
+namespace edupals
+{
+    namespace n4d
+    {
+        namespace typed
+        {
+            template <>
+            class Traits<BenchVariable> : public Struct<BenchVariable>
+            {
+                public:
+                
+                static void fields(Fields<BenchVariable>& fields)
+                {
+                    fields.add("value",&BenchVariable::value);
+                    fields.add("description",&BenchVariable::description);
+                    fields.add("volatile",&BenchVariable::is_volatile);
+                    fields.add("force_update",&BenchVariable::force_update);
+                    fields.add("inheritance",&BenchVariable::inheritance);
+                    fields.add("timestamp",&BenchVariable::timestamp);
+                    fields.add("id",&BenchVariable::id);
+                }
+            };
+        }
+    }
+}
+
+/*
+    Counts scalars of a streamed value
+*/
+class BenchCounter: public n4d::Visitor
+{
+    public:
+    
+    size_t values = 0;
+    
+    void value(const Variant&) override
+    {
+        values++;
+    }
+};
+
+static string filter;
+static Variant sink;
+
+template <class F>
+static void run(string name,size_t bytes,F fn)
+{
+    if (filter.size()>0 and name.find(filter)==string::npos) {
+        return;
+    }
+    
+    // warm up
+    fn();
+    
+    size_t iterations=1;
+    
+    while (true) {
+        uint64_t allocs=allocations.load();
+        Clock::time_point start=Clock::now();
+        
+        for (size_t n=0;n<iterations;n++) {
+            fn();
+        }
+        
+        double secs=std::chrono::duration<double>(Clock::now()-start).count();
+        allocs=allocations.load()-allocs;
+        
+        if (secs<0.25 and iterations<(1<<24)) {
+            iterations*=(secs<0.025) ? 10 : 2;
+            continue;
+        }
+        
+        double ns=(secs*1e9)/iterations;
+        
+        cout<<std::left<<std::setw(36)<<name<<std::right
+            <<std::setw(12)<<iterations<<" ops"
+            <<std::setw(14)<<std::fixed<<std::setprecision(1)<<ns<<" ns/op";
+        
+        if (bytes>0) {
+            cout<<std::setw(10)<<std::setprecision(1)<<((bytes*iterations)/secs)/(1024.0*1024.0)<<" MB/s";
+        }
+        else {
+            cout<<std::setw(15)<<" ";
+        }
+        
+        cout<<std::setw(10)<<std::setprecision(1)<<double(allocs)/iterations<<" allocs/op"<<endl;
+        
+        return;
+    }
+}
+
+static void setup(stringstream& out)
+{
+    out.imbue(std::locale("C"));
+    out<<std::setprecision(10)<<std::fixed;
+}
+
+/*
+    A variable as returned by get_variable(name,true)
+*/
+static Variant create_variable(int n)
+{
+    Variant var=Variant::create_struct();
+    
+    var["value"]="10.2.1."+std::to_string(n%255);
+    var["description"]="Server address for classroom "+std::to_string(n);
+    var["volatile"]=false;
+    var["force_update"]=false;
+    var["inheritance"]=Variant::create_array(0);
+    var["inheritance"].append("server");
+    var["timestamp"]=1600000000.0+n;
+    var["id"]=n;
+    
+    return var;
+}
+
+/*
+    A variable store as returned by get_variables(true)
+*/
+static Variant create_store(int size)
+{
+    Variant store=Variant::create_struct();
+    
+    for (int n=0;n<size;n++) {
+        store["VARIABLE_"+std::to_string(n)]=create_variable(n);
+    }
+    
+    return store;
+}
+
+static string create_response(BenchClient& client,Variant value)
+{
+    stringstream out;
+    setup(out);
+    
+    Variant response=Variant::create_struct();
+    response["status"]=0;
+    response["msg"]="";
+    response["return"]=value;
+    
+    out<<"<?xml version=\"1.0\"?><methodResponse><params><param>";
+    client.create_value(response,out);
+    out<<"</param></params></methodResponse>";
+    
+    return out.str();
+}
+
+int main(int argc,char* argv[])
+{
+    if (argc>1) {
+        filter=argv[1];
+    }
+    
+    BenchClient client;
+    
+    cout<<"* corpus: get_variables(true) like stores"<<endl;
+    
+    for (int size : {1,10,100,1000,10000}) {
+        Variant store=create_store(size);
+        string response=create_response(client,store);
+        string tag="/"+std::to_string(size);
+        
+        size_t request_size;
+        {
+            stringstream out;
+            setup(out);
+            client.create_request("set_variable",{"",string("STORE"),store,Variant::create_struct()},out);
+            request_size=out.str().size();
+        }
+        
+        run("create_value"+tag,request_size,[&]() {
+            stringstream out;
+            setup(out);
+            client.create_value(store,out);
+        });
+        
+        run("create_request"+tag,request_size,[&]() {
+            stringstream out;
+            setup(out);
+            client.create_request("set_variable",{"",string("STORE"),store,Variant::create_struct()},out);
+        });
+        
+        run("parse_response"+tag,response.size(),[&]() {
+            sink=client.parse_response(response);
+        });
+        
+        BenchClient interned;
+        interned.set_interning(n4d::Interning::Call);
+        
+        run("parse_response/interned"+tag,response.size(),[&]() {
+            sink=interned.parse_response(response);
+        });
+        
+        // table kept across responses, as for cached values
+        BenchClient shared;
+        shared.set_interning(n4d::Interning::Client);
+        
+        run("parse_response/shared"+tag,response.size(),[&]() {
+            sink=shared.parse_response(response);
+        });
+        
+        Variant parsed=client.parse_response(response);
+        
+        run("validate_format"+tag,0,[&]() {
+            sink=client.validate_format(parsed);
+        });
+        
+        run("validate"+tag,0,[&]() {
+            sink=client.validate(parsed,"N4D","get_variables");
+        });
+        
+        // whole call pipeline, without sockets
+        BenchClient loopback;
+        loopback.set_transport(std::make_shared<n4d::LoopbackTransport>([&](const string&) {
+            return response;
+        }));
+        
+        run("get_variables/loopback"+tag,response.size(),[&]() {
+            sink=loopback.get_variables(true);
+        });
+        
+        // filling user structs from a Variant tree against direct decoding
+        run("decode/variant"+tag,response.size(),[&]() {
+            Variant vars=loopback.get_variables(true);
+            map<string,BenchVariable> out;
+            
+            for (string& key : vars.keys()) {
+                Variant var=vars[key];
+                BenchVariable& v=out[key];
+                
+                v.value=var["value"].get_string();
+                v.description=var["description"].get_string();
+                v.is_volatile=var["volatile"].get_boolean();
+                v.force_update=var["force_update"].get_boolean();
+                
+                for (size_t n=0;n<var["inheritance"].count();n++) {
+                    v.inheritance.push_back(var["inheritance"][n].get_string());
+                }
+                
+                v.timestamp=var["timestamp"].get_double();
+                v.id=var["id"].get_int32();
+            }
+        });
+        
+        run("decode/typed"+tag,response.size(),[&]() {
+            map<string,BenchVariable> out=loopback.call<map<string,BenchVariable> >("N4D","get_variables");
+        });
+        
+        // reading a single field out of the whole store
+        run("sparse/variant"+tag,response.size(),[&]() {
+            sink=loopback.get_variables(true)["VARIABLE_0"]["value"];
+        });
+        
+        run("sparse/view"+tag,response.size(),[&]() {
+            sink=loopback.get_variables_view(true)["VARIABLE_0"]["value"].get_string();
+        });
+        
+        // visiting every value, without holding the whole store
+        run("visit/variant"+tag,response.size(),[&]() {
+            Variant vars=loopback.get_variables(true);
+            size_t values=0;
+            
+            for (string& key : vars.keys()) {
+                values+=vars[key].keys().size();
+            }
+            
+            sink=static_cast<int32_t>(values);
+        });
+        
+        run("visit/stream"+tag,response.size(),[&]() {
+            BenchCounter counter;
+            loopback.builtin_call("get_variables",{true},counter);
+            
+            sink=static_cast<int32_t>(counter.values);
+        });
+    }
+    
+    size_t cores=std::max(1u,std::thread::hardware_concurrency());
+    
+    cout<<"* parallel decoding: arrays of variables, 1 to "<<cores<<" threads"<<endl;
+    
+    for (int size : {1000,10000}) {
+        Variant array=Variant::create_array(0);
+        
+        for (int n=0;n<size;n++) {
+            array.append(create_variable(n));
+        }
+        
+        string response=create_response(client,array);
+        string tag="/"+std::to_string(size);
+        
+        for (size_t threads=1;threads<=cores;threads*=2) {
+            BenchClient parallel;
+            parallel.set_parallel_decoding(1000,threads);
+            
+            run("parse/parallel"+tag+"/"+std::to_string(threads),response.size(),[&]() {
+                sink=parallel.parse_response(response);
+            });
+        }
+    }
+    
+    cout<<"* text kernels: long string payloads, detected "
+        <<n4d::xmlrpc::kernel::level_name(n4d::xmlrpc::kernel::detect())<<endl;
+    
+    for (size_t size : {1024,65536,1048576}) {
+        // mostly plain text, with some markup to escape
+        string text;
+        
+        for (size_t n=0;n<size;n++) {
+            text+=(n%97==0) ? '<' : (n%211==0) ? '&' : static_cast<char>('a'+n%26);
+        }
+        
+        string escaped;
+        n4d::xmlrpc::kernel::escape(text.c_str(),text.size(),escaped);
+        
+        vector<uint8_t> blob(text.begin(),text.end());
+        
+        // with line breaks every 76 characters, as python sends it
+        string encoded;
+        {
+            string plain;
+            n4d::xmlrpc::kernel::base64_encode(blob.data(),blob.size(),plain);
+            
+            for (size_t n=0;n<plain.size();n+=76) {
+                encoded+=plain.substr(n,76)+"\n";
+            }
+        }
+        
+        string tag="/"+std::to_string(size);
+        
+        for (auto level : {n4d::xmlrpc::kernel::Level::Scalar,n4d::xmlrpc::kernel::Level::SSE2,
+                           n4d::xmlrpc::kernel::Level::AVX2}) {
+            n4d::xmlrpc::kernel::set_level(level);
+            
+            if (n4d::xmlrpc::kernel::get_level()!=level) {
+                continue;
+            }
+            
+            string name=n4d::xmlrpc::kernel::level_name(level);
+            
+            run("find/"+name+tag,size,[&]() {
+                sink=static_cast<int32_t>(n4d::xmlrpc::kernel::find(escaped.c_str(),escaped.size(),'\0'));
+            });
+            
+            run("escape/"+name+tag,size,[&]() {
+                string out;
+                n4d::xmlrpc::kernel::escape(text.c_str(),text.size(),out);
+            });
+            
+            run("unescape/"+name+tag,escaped.size(),[&]() {
+                string out;
+                n4d::xmlrpc::kernel::unescape(escaped.c_str(),escaped.size(),out);
+            });
+            
+            run("base64/encode/"+name+tag,size,[&]() {
+                string out;
+                n4d::xmlrpc::kernel::base64_encode(blob.data(),blob.size(),out);
+            });
+            
+            run("base64/decode/"+name+tag,encoded.size(),[&]() {
+                vector<uint8_t> out;
+                n4d::xmlrpc::kernel::base64_decode(encoded.c_str(),encoded.size(),out);
+            });
+        }
+        
+        n4d::xmlrpc::kernel::set_level(n4d::xmlrpc::kernel::detect());
+        
+        Variant value=text;
+        
+        run("create_value/string"+tag,size,[&]() {
+            stringstream out;
+            setup(out);
+            client.create_value(value,out);
+        });
+    }
+    
+    cout<<"* typed calls: call<R>() against call() with Variant params"<<endl;
+    
+    for (int size : {1,10,100,1000}) {
+        string tag="/"+std::to_string(size);
+        
+        vector<string> names;
+        map<string,int32_t> counters;
+        
+        for (int n=0;n<size;n++) {
+            names.push_back("VARIABLE_"+std::to_string(n));
+            counters["counter_"+std::to_string(n)]=n;
+        }
+        
+        run("request/variant"+tag,0,[&]() {
+            Variant array=Variant::create_array(0);
+            Variant map=Variant::create_struct();
+            
+            for (string& name : names) {
+                array.append(name);
+            }
+            
+            for (auto& counter : counters) {
+                map[counter.first]=counter.second;
+            }
+            
+            stringstream out;
+            setup(out);
+            client.create_request("method",{"",string("Plugin"),7,string("classroom"),array,map},out);
+        });
+        
+        run("request/typed"+tag,0,[&]() {
+            string request;
+            client.begin_call("Plugin","method",request);
+            n4d::typed::param(7,request);
+            n4d::typed::param("classroom",request);
+            n4d::typed::param(names,request);
+            n4d::typed::param(counters,request);
+            request+="</params></methodCall>";
+        });
+        
+        Variant result=Variant::create_array(0);
+        
+        for (string& name : names) {
+            result.append(name);
+        }
+        
+        string response=create_response(client,result);
+        
+        BenchClient loopback;
+        loopback.set_transport(std::make_shared<n4d::LoopbackTransport>([&](const string&) {
+            return response;
+        }));
+        
+        run("call/variant/loopback"+tag,0,[&]() {
+            Variant array=Variant::create_array(0);
+            
+            for (string& name : names) {
+                array.append(name);
+            }
+            
+            Variant ret=loopback.call("Plugin","method",{7,string("classroom"),array});
+            vector<string> values;
+            
+            for (size_t n=0;n<ret.count();n++) {
+                values.push_back(ret[n].get_string());
+            }
+        });
+        
+        run("call/typed/loopback"+tag,0,[&]() {
+            vector<string> values=loopback.call<vector<string> >("Plugin","method",7,"classroom",names);
+        });
+    }
+    
+    cout<<"* credentials"<<endl;
+    
+    string key(50,'a');
+    for (size_t n=0;n<key.size();n++) {
+        key[n]="abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"[(n*7)%62];
+    }
+    
+    string ticket="N4DTKV2 https://server:9779 netadmin "+key;
+    
+    run("Ticket",ticket.size(),[&]() {
+        n4d::Ticket t(ticket);
+        sink=t.valid();
+    });
+    
+    run("Key::valid",key.size(),[&]() {
+        n4d::auth::Key k(key);
+        sink=k.valid();
+    });
+    
+    return 0;
+}
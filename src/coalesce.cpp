@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d-coalesce.hpp>
+
+using namespace edupals;
+using namespace edupals::variant;
+using namespace edupals::n4d;
+
+using namespace std;
+
+Coalescer::Coalescer()
+{
+    sent.store(0);
+    coalesced.store(0);
+    
+    for (string method : {"get_variable","get_variables","variable_exists",
+                          "get_version","get_methods"}) {
+        add("N4D",method);
+    }
+}
+
+void Coalescer::add(string name,string method)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    methods.insert(name+"."+method);
+}
+
+void Coalescer::remove(string name,string method)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    methods.erase(name+"."+method);
+}
+
+bool Coalescer::idempotent(const string& name,const string& method)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return (methods.find(name+"."+method)!=methods.end());
+}
+
+Variant Coalescer::run(const string& key,std::function<Variant()> function)
+{
+    shared_ptr<Flight> flight;
+    bool leader=false;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it=flights.find(key);
+        
+        if (it==flights.end()) {
+            flight=std::make_shared<Flight>();
+            flights[key]=flight;
+            leader=true;
+        }
+        else {
+            flight=it->second;
+        }
+    }
+    
+    if (!leader) {
+        coalesced.fetch_add(1,std::memory_order_relaxed);
+        
+        std::unique_lock<std::mutex> lock(flight->mutex);
+        flight->ready.wait(lock,[&flight]() {
+            return flight->done;
+        });
+        
+        if (flight->error) {
+            std::rethrow_exception(flight->error);
+        }
+        
+        return flight->value;
+    }
+    
+    sent.fetch_add(1,std::memory_order_relaxed);
+    
+    Variant value;
+    std::exception_ptr error;
+    
+    try {
+        value=function();
+    }
+    catch (...) {
+        error=std::current_exception();
+    }
+    
+    // late callers start a new flight from here
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        flights.erase(key);
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(flight->mutex);
+        flight->value=value;
+        flight->error=error;
+        flight->done=true;
+    }
+    
+    flight->ready.notify_all();
+    
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    
+    return value;
+}
+
+uint64_t Coalescer::get_flights()
+{
+    return sent.load();
+}
+
+uint64_t Coalescer::get_coalesced()
+{
+    return coalesced.load();
+}
+
+int64_t Coalescer::get_in_flight()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return flights.size();
+}
+
+Variant Coalescer::stats()
+{
+    Variant ret=Variant::create_struct();
+    
+    // counters of long running processes would overflow an int32
+    ret["flights"]=static_cast<double>(get_flights());
+    ret["coalesced"]=static_cast<double>(get_coalesced());
+    ret["in_flight"]=static_cast<int32_t>(get_in_flight());
+    
+    return ret;
+}
@@ -0,0 +1,661 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include "kernel.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && defined(__SSE2__)
+#define N4D_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+using namespace edupals::n4d;
+
+using namespace std;
+
+namespace
+{
+    size_t scalar_find(const char* data,size_t size,char c)
+    {
+        for (size_t n=0;n<size;n++) {
+            if (data[n]==c) {
+                return n;
+            }
+        }
+        
+        return size;
+    }
+    
+    size_t scalar_find_markup(const char* data,size_t size)
+    {
+        for (size_t n=0;n<size;n++) {
+            char c=data[n];
+            
+            if (c=='<' or c=='&' or c=='>') {
+                return n;
+            }
+        }
+        
+        return size;
+    }
+    
+#ifdef N4D_KERNEL_X86
+    size_t sse2_find(const char* data,size_t size,char c)
+    {
+        const __m128i needle=_mm_set1_epi8(c);
+        size_t n=0;
+        
+        for (;n+16<=size;n+=16) {
+            __m128i block=_mm_loadu_si128(reinterpret_cast<const __m128i*>(data+n));
+            int mask=_mm_movemask_epi8(_mm_cmpeq_epi8(block,needle));
+            
+            if (mask) {
+                return n+__builtin_ctz(mask);
+            }
+        }
+        
+        return n+scalar_find(data+n,size-n,c);
+    }
+    
+    size_t sse2_find_markup(const char* data,size_t size)
+    {
+        const __m128i lt=_mm_set1_epi8('<');
+        const __m128i amp=_mm_set1_epi8('&');
+        const __m128i gt=_mm_set1_epi8('>');
+        size_t n=0;
+        
+        for (;n+16<=size;n+=16) {
+            __m128i block=_mm_loadu_si128(reinterpret_cast<const __m128i*>(data+n));
+            __m128i hits=_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block,lt),_mm_cmpeq_epi8(block,amp)),
+                                      _mm_cmpeq_epi8(block,gt));
+            int mask=_mm_movemask_epi8(hits);
+            
+            if (mask) {
+                return n+__builtin_ctz(mask);
+            }
+        }
+        
+        return n+scalar_find_markup(data+n,size-n);
+    }
+    
+    __attribute__((target("avx2")))
+    size_t avx2_find(const char* data,size_t size,char c)
+    {
+        const __m256i needle=_mm256_set1_epi8(c);
+        size_t n=0;
+        
+        for (;n+32<=size;n+=32) {
+            __m256i block=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data+n));
+            uint32_t mask=_mm256_movemask_epi8(_mm256_cmpeq_epi8(block,needle));
+            
+            if (mask) {
+                return n+__builtin_ctz(mask);
+            }
+        }
+        
+        return n+sse2_find(data+n,size-n,c);
+    }
+    
+    __attribute__((target("avx2")))
+    size_t avx2_find_markup(const char* data,size_t size)
+    {
+        const __m256i lt=_mm256_set1_epi8('<');
+        const __m256i amp=_mm256_set1_epi8('&');
+        const __m256i gt=_mm256_set1_epi8('>');
+        size_t n=0;
+        
+        for (;n+32<=size;n+=32) {
+            __m256i block=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data+n));
+            __m256i hits=_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block,lt),
+                                                         _mm256_cmpeq_epi8(block,amp)),
+                                         _mm256_cmpeq_epi8(block,gt));
+            uint32_t mask=_mm256_movemask_epi8(hits);
+            
+            if (mask) {
+                return n+__builtin_ctz(mask);
+            }
+        }
+        
+        return n+sse2_find_markup(data+n,size-n);
+    }
+#endif
+    
+    const char base64_alphabet[]="ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    
+    // 0-63 for alphabet, 64 whitespace, 65 padding, 255 invalid
+    class Base64Table
+    {
+        public:
+        
+        uint8_t values[256];
+        
+        Base64Table()
+        {
+            for (int n=0;n<256;n++) {
+                values[n]=255;
+            }
+            
+            for (int n=0;n<64;n++) {
+                values[static_cast<uint8_t>(base64_alphabet[n])]=n;
+            }
+            
+            values[static_cast<uint8_t>(' ')]=64;
+            values[static_cast<uint8_t>('\t')]=64;
+            values[static_cast<uint8_t>('\r')]=64;
+            values[static_cast<uint8_t>('\n')]=64;
+            values[static_cast<uint8_t>('=')]=65;
+        }
+    };
+    
+    const Base64Table base64_table;
+    
+    // encodes whole 3 byte groups, returns bytes used
+    size_t scalar_base64_encode(const uint8_t* data,size_t size,char* out)
+    {
+        size_t n=0;
+        
+        for (;n+3<=size;n+=3) {
+            uint32_t group=(data[n]<<16) | (data[n+1]<<8) | data[n+2];
+            
+            *out++=base64_alphabet[(group>>18) & 0x3f];
+            *out++=base64_alphabet[(group>>12) & 0x3f];
+            *out++=base64_alphabet[(group>>6) & 0x3f];
+            *out++=base64_alphabet[group & 0x3f];
+        }
+        
+        return n;
+    }
+    
+    /*
+        Decodes 16 characters into 12 bytes at out, which must have room
+        for 16. False if any of them is not in the alphabet, leaving the
+        index of first offending one in bad
+    */
+    typedef bool (*Base64Block)(const char* text,uint8_t* out,size_t& bad);
+    
+#ifdef N4D_KERNEL_X86
+    // 12 bytes into 16 characters, input must be 16 bytes readable
+    __attribute__((target("ssse3")))
+    void ssse3_base64_encode_block(const uint8_t* data,char* out)
+    {
+        __m128i in=_mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        
+        // every 3 bytes into 4 lanes of 6 bits
+        in=_mm_shuffle_epi8(in,_mm_set_epi8(10,11,9,10,7,8,6,7,4,5,3,4,1,2,0,1));
+        __m128i t0=_mm_and_si128(in,_mm_set1_epi32(0x0fc0fc00));
+        __m128i t1=_mm_mulhi_epu16(t0,_mm_set1_epi32(0x04000040));
+        __m128i t2=_mm_and_si128(in,_mm_set1_epi32(0x003f03f0));
+        __m128i t3=_mm_mullo_epi16(t2,_mm_set1_epi32(0x01000010));
+        __m128i indices=_mm_or_si128(t1,t3);
+        
+        // offset to add to each index, by alphabet range
+        __m128i range=_mm_subs_epu8(indices,_mm_set1_epi8(51));
+        __m128i less=_mm_cmpgt_epi8(_mm_set1_epi8(26),indices);
+        range=_mm_or_si128(range,_mm_and_si128(less,_mm_set1_epi8(13)));
+        
+        const __m128i offsets=_mm_setr_epi8('a'-26,'0'-52,'0'-52,'0'-52,'0'-52,'0'-52,'0'-52,
+                                            '0'-52,'0'-52,'0'-52,'0'-52,'+'-62,'/'-63,'A',0,0);
+        
+        __m128i chars=_mm_add_epi8(_mm_shuffle_epi8(offsets,range),indices);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out),chars);
+    }
+    
+    __attribute__((target("ssse3")))
+    bool ssse3_base64_decode_block(const char* text,uint8_t* out,size_t& bad)
+    {
+        __m128i in=_mm_loadu_si128(reinterpret_cast<const __m128i*>(text));
+        
+        // bytes above 127 are negative, so out of every range
+        __m128i upper=_mm_and_si128(_mm_cmpgt_epi8(in,_mm_set1_epi8('A'-1)),_mm_cmpgt_epi8(_mm_set1_epi8('Z'+1),in));
+        __m128i lower=_mm_and_si128(_mm_cmpgt_epi8(in,_mm_set1_epi8('a'-1)),_mm_cmpgt_epi8(_mm_set1_epi8('z'+1),in));
+        __m128i digit=_mm_and_si128(_mm_cmpgt_epi8(in,_mm_set1_epi8('0'-1)),_mm_cmpgt_epi8(_mm_set1_epi8('9'+1),in));
+        __m128i plus=_mm_cmpeq_epi8(in,_mm_set1_epi8('+'));
+        __m128i slash=_mm_cmpeq_epi8(in,_mm_set1_epi8('/'));
+        
+        __m128i valid=_mm_or_si128(_mm_or_si128(upper,lower),_mm_or_si128(_mm_or_si128(digit,plus),slash));
+        int mask=_mm_movemask_epi8(valid);
+        
+        if (mask!=0xffff) {
+            bad=__builtin_ctz(~mask);
+            return false;
+        }
+        
+        __m128i shift=_mm_or_si128(_mm_and_si128(upper,_mm_set1_epi8(-65)),_mm_and_si128(lower,_mm_set1_epi8(-71)));
+        shift=_mm_or_si128(shift,_mm_and_si128(digit,_mm_set1_epi8(4)));
+        shift=_mm_or_si128(shift,_mm_and_si128(plus,_mm_set1_epi8(19)));
+        shift=_mm_or_si128(shift,_mm_and_si128(slash,_mm_set1_epi8(16)));
+        
+        __m128i values=_mm_add_epi8(in,shift);
+        
+        // 4 lanes of 6 bits into 3 bytes, in order
+        __m128i pairs=_mm_maddubs_epi16(values,_mm_set1_epi32(0x01400140));
+        __m128i groups=_mm_madd_epi16(pairs,_mm_set1_epi32(0x00011000));
+        groups=_mm_shuffle_epi8(groups,_mm_setr_epi8(2,1,0,6,5,4,10,9,8,14,13,12,-1,-1,-1,-1));
+        
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out),groups);
+        
+        return true;
+    }
+    
+    bool ssse3_supported()
+    {
+        __builtin_cpu_init();
+        
+        return __builtin_cpu_supports("ssse3");
+    }
+    
+    const bool ssse3=ssse3_supported();
+#endif
+    
+    class Kernels
+    {
+        public:
+        
+        size_t (*find)(const char*,size_t,char);
+        size_t (*find_markup)(const char*,size_t);
+        
+        /*! null when there is no vector base64 */
+        void (*base64_encode_block)(const uint8_t*,char*);
+        Base64Block base64_decode_block;
+    };
+    
+    const Kernels scalar_kernels={scalar_find,scalar_find_markup,nullptr,nullptr};
+    
+#ifdef N4D_KERNEL_X86
+    const Kernels sse2_kernels={sse2_find,sse2_find_markup,nullptr,nullptr};
+    const Kernels avx2_kernels={avx2_find,avx2_find_markup,nullptr,nullptr};
+    
+    // both levels imply ssse3 in practice, but it is checked anyway
+    const Kernels sse2_ssse3_kernels={sse2_find,sse2_find_markup,
+                                      ssse3_base64_encode_block,ssse3_base64_decode_block};
+    const Kernels avx2_ssse3_kernels={avx2_find,avx2_find_markup,
+                                      ssse3_base64_encode_block,ssse3_base64_decode_block};
+#endif
+    
+    const Kernels* select(xmlrpc::kernel::Level level)
+    {
+        switch (level) {
+#ifdef N4D_KERNEL_X86
+            case xmlrpc::kernel::Level::AVX2:
+                return ssse3 ? &avx2_ssse3_kernels : &avx2_kernels;
+            
+            case xmlrpc::kernel::Level::SSE2:
+                return ssse3 ? &sse2_ssse3_kernels : &sse2_kernels;
+#endif
+            default:
+                return &scalar_kernels;
+        }
+    }
+    
+    std::atomic<int> current(-1);
+    
+    const Kernels* kernels()
+    {
+        int level=current.load(std::memory_order_relaxed);
+        
+        if (level<0) {
+            level=static_cast<int>(xmlrpc::kernel::detect());
+            current.store(level,std::memory_order_relaxed);
+        }
+        
+        return select(static_cast<xmlrpc::kernel::Level>(level));
+    }
+    
+    // parses digits of a character reference, empty or partial numbers
+    // and code points that are not xml characters are rejected
+    bool char_reference(const char* digits,size_t size,unsigned long& code)
+    {
+        unsigned long base=10;
+        
+        if (size>0 and digits[0]=='x') {
+            base=16;
+            digits++;
+            size--;
+        }
+        
+        if (size==0) {
+            return false;
+        }
+        
+        code=0;
+        
+        for (size_t n=0;n<size;n++) {
+            char c=digits[n];
+            unsigned long digit;
+            
+            if (c>='0' and c<='9') {
+                digit=c-'0';
+            }
+            else if (base==16 and c>='a' and c<='f') {
+                digit=c-'a'+10;
+            }
+            else if (base==16 and c>='A' and c<='F') {
+                digit=c-'A'+10;
+            }
+            else {
+                return false;
+            }
+            
+            code=code*base+digit;
+            
+            if (code>0x10ffff) {
+                return false;
+            }
+        }
+        
+        return (code!=0 and (code<0xd800 or code>0xdfff));
+    }
+    
+    // appends utf-8 encoding of a character reference
+    void append_utf8(unsigned long code,string& out)
+    {
+        if (code<0x80) {
+            out+=static_cast<char>(code);
+        }
+        else if (code<0x800) {
+            out+=static_cast<char>(0xc0 | (code>>6));
+            out+=static_cast<char>(0x80 | (code & 0x3f));
+        }
+        else if (code<0x10000) {
+            out+=static_cast<char>(0xe0 | (code>>12));
+            out+=static_cast<char>(0x80 | ((code>>6) & 0x3f));
+            out+=static_cast<char>(0x80 | (code & 0x3f));
+        }
+        else {
+            out+=static_cast<char>(0xf0 | (code>>18));
+            out+=static_cast<char>(0x80 | ((code>>12) & 0x3f));
+            out+=static_cast<char>(0x80 | ((code>>6) & 0x3f));
+            out+=static_cast<char>(0x80 | (code & 0x3f));
+        }
+    }
+}
+
+xmlrpc::kernel::Level xmlrpc::kernel::detect()
+{
+#ifdef N4D_KERNEL_X86
+    __builtin_cpu_init();
+    
+    if (__builtin_cpu_supports("avx2")) {
+        return Level::AVX2;
+    }
+    
+    return Level::SSE2;
+#else
+    return Level::Scalar;
+#endif
+}
+
+xmlrpc::kernel::Level xmlrpc::kernel::get_level()
+{
+    kernels();
+    
+    return static_cast<Level>(current.load(std::memory_order_relaxed));
+}
+
+void xmlrpc::kernel::set_level(Level level)
+{
+    Level best=detect();
+    
+    if (static_cast<int>(level)>static_cast<int>(best)) {
+        level=best;
+    }
+    
+    current.store(static_cast<int>(level),std::memory_order_relaxed);
+}
+
+const char* xmlrpc::kernel::level_name(Level level)
+{
+    switch (level) {
+        case Level::SSE2:
+            return "sse2";
+        
+        case Level::AVX2:
+            return "avx2";
+        
+        default:
+            return "scalar";
+    }
+}
+
+size_t xmlrpc::kernel::find(const char* data,size_t size,char c)
+{
+    return kernels()->find(data,size,c);
+}
+
+size_t xmlrpc::kernel::find_markup(const char* data,size_t size)
+{
+    return kernels()->find_markup(data,size);
+}
+
+void xmlrpc::kernel::escape(const char* data,size_t size,string& out)
+{
+    const Kernels* k=kernels();
+    size_t n=0;
+    
+    out.reserve(out.size()+size);
+    
+    while (n<size) {
+        size_t run=k->find_markup(data+n,size-n);
+        out.append(data+n,run);
+        n+=run;
+        
+        if (n==size) {
+            break;
+        }
+        
+        switch (data[n]) {
+            case '<':
+                out+="&lt;";
+            break;
+            
+            case '>':
+                out+="&gt;";
+            break;
+            
+            default:
+                out+="&amp;";
+        }
+        
+        n++;
+    }
+}
+
+void xmlrpc::kernel::unescape(const char* data,size_t size,string& out)
+{
+    const Kernels* k=kernels();
+    size_t n=0;
+    unsigned long code;
+    
+    out.reserve(out.size()+size);
+    
+    while (n<size) {
+        size_t run=k->find(data+n,size-n,'&');
+        out.append(data+n,run);
+        n+=run;
+        
+        if (n==size) {
+            break;
+        }
+        
+        size_t semicolon=n+1+k->find(data+n+1,size-n-1,';');
+        
+        if (semicolon==size) {
+            out.append(data+n,size-n);
+            break;
+        }
+        
+        const char* entity=data+n+1;
+        size_t length=semicolon-n-1;
+        
+        if (length==2 and std::memcmp(entity,"lt",2)==0) {
+            out+='<';
+        }
+        else if (length==2 and std::memcmp(entity,"gt",2)==0) {
+            out+='>';
+        }
+        else if (length==3 and std::memcmp(entity,"amp",3)==0) {
+            out+='&';
+        }
+        else if (length==4 and std::memcmp(entity,"quot",4)==0) {
+            out+='"';
+        }
+        else if (length==4 and std::memcmp(entity,"apos",4)==0) {
+            out+='\'';
+        }
+        else if (length>1 and entity[0]=='#' and char_reference(entity+1,length-1,code)) {
+            append_utf8(code,out);
+        }
+        else {
+            out.append(data+n,length+2);
+        }
+        
+        n=semicolon+1;
+    }
+}
+
+void xmlrpc::kernel::base64_encode(const uint8_t* data,size_t size,string& out)
+{
+    const Kernels* k=kernels();
+    size_t start=out.size();
+    
+    out.resize(start+((size+2)/3)*4);
+    char* cursor=&out[start];
+    size_t n=0;
+    
+    if (k->base64_encode_block) {
+        // blocks read 16 bytes to use 12
+        for (;n+16<=size;n+=12) {
+            k->base64_encode_block(data+n,cursor);
+            cursor+=16;
+        }
+    }
+    
+    size_t used=scalar_base64_encode(data+n,size-n,cursor);
+    cursor+=(used/3)*4;
+    n+=used;
+    
+    if (n<size) {
+        uint32_t group=data[n]<<16;
+        
+        if (n+1<size) {
+            group|=data[n+1]<<8;
+        }
+        
+        cursor[0]=base64_alphabet[(group>>18) & 0x3f];
+        cursor[1]=base64_alphabet[(group>>12) & 0x3f];
+        cursor[2]=(n+1<size) ? base64_alphabet[(group>>6) & 0x3f] : '=';
+        cursor[3]='=';
+    }
+}
+
+bool xmlrpc::kernel::base64_decode(const char* text,size_t size,vector<uint8_t>& out)
+{
+    const Kernels* k=kernels();
+    size_t start=out.size();
+    
+    // room for whole text plus block slack, trimmed at the end
+    out.resize(start+(size/4)*3+16);
+    uint8_t* cursor=out.data()+start;
+    
+    uint32_t group=0;
+    int count=0;
+    int padding=0;
+    size_t n=0;
+    size_t scalar=0;
+    
+    while (n<size) {
+        // blocks start on group boundaries, past any character they refused
+        if (n>=scalar and count==0 and padding==0 and k->base64_decode_block and n+16<=size) {
+            size_t bad=0;
+            
+            if (k->base64_decode_block(text+n,cursor,bad)) {
+                cursor+=12;
+                n+=16;
+                continue;
+            }
+            
+            scalar=n+bad+1;
+        }
+        
+        uint8_t value=base64_table.values[static_cast<uint8_t>(text[n])];
+        n++;
+        
+        if (value==64) {
+            continue;
+        }
+        
+        if (value==65) {
+            padding++;
+            continue;
+        }
+        
+        // nothing but whitespace and padding after padding
+        if (value==255 or padding>0) {
+            out.resize(start);
+            return false;
+        }
+        
+        group=(group<<6) | value;
+        count++;
+        
+        if (count==4) {
+            *cursor++=(group>>16) & 0xff;
+            *cursor++=(group>>8) & 0xff;
+            *cursor++=group & 0xff;
+            group=0;
+            count=0;
+        }
+    }
+    
+    // trailing partial group, padding is optional
+    bool valid=false;
+    
+    switch (count) {
+        case 0:
+            valid=(padding==0);
+        break;
+        
+        case 2:
+            valid=(padding==0 or padding==2);
+            *cursor++=(group>>4) & 0xff;
+        break;
+        
+        case 3:
+            valid=(padding<=1);
+            *cursor++=(group>>10) & 0xff;
+            *cursor++=(group>>2) & 0xff;
+        break;
+    }
+    
+    if (!valid) {
+        out.resize(start);
+        return false;
+    }
+    
+    out.resize(cursor-out.data());
+    
+    return true;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef EDUPALS_N4D_KERNEL
+#define EDUPALS_N4D_KERNEL
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/*
+    Character data kernels used when writing and reading xml-rpc
+*/
+
+namespace edupals
+{
+    namespace n4d
+    {
+        namespace xmlrpc
+        {
+            namespace kernel
+            {
+                /*!
+                 * Instruction sets kernels can run on
+                */
+                enum class Level
+                {
+                    Scalar,
+                    SSE2,
+                    AVX2
+                };
+                
+                /*!
+                 * Best level supported by running cpu
+                */
+                Level detect();
+                
+                /*!
+                 * Level in use, detected one by default
+                */
+                Level get_level();
+                
+                /*!
+                 * Forces a level, for comparison purposes. Levels beyond
+                 * detected one are lowered to it
+                */
+                void set_level(Level level);
+                
+                const char* level_name(Level level);
+                
+                /*!
+                 * Index of first c in data, or size if missing
+                */
+                size_t find(const char* data,size_t size,char c);
+                
+                /*!
+                 * Index of first '<', '&' or '>' in data, or size if missing
+                */
+                size_t find_markup(const char* data,size_t size);
+                
+                /*!
+                 * Appends data as xml character data
+                */
+                void escape(const char* data,size_t size,std::string& out);
+                
+                /*!
+                 * Appends xml character data translating entities and
+                 * character references, unknown ones are left as they are
+                */
+                void unescape(const char* data,size_t size,std::string& out);
+                
+                /*!
+                 * Appends base64 encoding of data, with no line breaks
+                */
+                void base64_encode(const uint8_t* data,size_t size,std::string& out);
+                
+                /*!
+                 * Appends decoded base64 text, skipping whitespace. Returns
+                 * false on malformed text. Vectorized paths need SSSE3
+                */
+                bool base64_decode(const char* text,size_t size,std::vector<uint8_t>& out);
+            }
+        }
+    }
+}
+
+#endif
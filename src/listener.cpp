@@ -0,0 +1,405 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include "listener.hpp"
+
+#include <n4d.hpp>
+
+#include <cstring>
+#include <cerrno>
+#include <cctype>
+#include <cstdlib>
+
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+using namespace edupals;
+using namespace edupals::n4d;
+using namespace edupals::n4d::http;
+
+using namespace std;
+
+// idle keep-alive connections are polled with this period so they notice stop()
+#define LISTENER_POLL_MS 250
+
+// a started request must keep arriving, or its connection is dropped
+#define LISTENER_TIMEOUT_MS 30000
+
+#define LISTENER_MAX_HEADER 65536
+
+static string lower(string in)
+{
+    for (char& c:in) {
+        c=std::tolower(c);
+    }
+    
+    return in;
+}
+
+static bool send_all(int fd,const string& data)
+{
+    size_t sent=0;
+    
+    while (sent<data.size()) {
+        ssize_t status=::send(fd,data.c_str()+sent,data.size()-sent,MSG_NOSIGNAL);
+        
+        if (status<0) {
+            if (errno==EINTR) {
+                continue;
+            }
+            return false;
+        }
+        
+        sent+=status;
+    }
+    
+    return true;
+}
+
+Listener::Listener(Handler handler,size_t workers) :
+    handler(handler), workers(workers), max_body(LISTENER_MAX_BODY), fd(-1)
+{
+    running.store(false);
+    
+    if (this->workers==0) {
+        this->workers=1;
+    }
+}
+
+Listener::~Listener()
+{
+    stop();
+    
+    if (fd>=0) {
+        ::close(fd);
+    }
+    
+    if (unix_path.size()>0) {
+        ::unlink(unix_path.c_str());
+    }
+}
+
+int Listener::listen_tcp(string address,int port)
+{
+    fd=::socket(AF_INET,SOCK_STREAM,0);
+    
+    if (fd<0) {
+        throw exception::ServerError(errno,"socket");
+    }
+    
+    int one=1;
+    setsockopt(fd,SOL_SOCKET,SO_REUSEADDR,&one,sizeof(one));
+    
+    struct sockaddr_in addr;
+    std::memset(&addr,0,sizeof(addr));
+    addr.sin_family=AF_INET;
+    addr.sin_port=htons(port);
+    
+    if (inet_pton(AF_INET,address.c_str(),&addr.sin_addr)!=1) {
+        throw exception::ServerError(0,"invalid address "+address);
+    }
+    
+    if (::bind(fd,(struct sockaddr*)&addr,sizeof(addr))<0) {
+        throw exception::ServerError(errno,"bind");
+    }
+    
+    if (::listen(fd,SOMAXCONN)<0) {
+        throw exception::ServerError(errno,"listen");
+    }
+    
+    socklen_t len=sizeof(addr);
+    getsockname(fd,(struct sockaddr*)&addr,&len);
+    
+    return ntohs(addr.sin_port);
+}
+
+void Listener::listen_unix(string path)
+{
+    fd=::socket(AF_UNIX,SOCK_STREAM,0);
+    
+    if (fd<0) {
+        throw exception::ServerError(errno,"socket");
+    }
+    
+    struct sockaddr_un addr;
+    std::memset(&addr,0,sizeof(addr));
+    addr.sun_family=AF_UNIX;
+    
+    if (path.size()>=sizeof(addr.sun_path)) {
+        throw exception::ServerError(0,"socket path too long");
+    }
+    
+    std::strncpy(addr.sun_path,path.c_str(),sizeof(addr.sun_path)-1);
+    ::unlink(path.c_str());
+    
+    if (::bind(fd,(struct sockaddr*)&addr,sizeof(addr))<0) {
+        throw exception::ServerError(errno,"bind");
+    }
+    
+    unix_path=path;
+    
+    if (::listen(fd,SOMAXCONN)<0) {
+        throw exception::ServerError(errno,"listen");
+    }
+}
+
+void Listener::start()
+{
+    if (running.exchange(true)) {
+        return;
+    }
+    
+    for (size_t n=0;n<workers;n++) {
+        pool.push_back(std::thread(&Listener::worker_loop,this));
+    }
+    
+    acceptor=std::thread(&Listener::accept_loop,this);
+}
+
+void Listener::stop()
+{
+    if (!running.exchange(false)) {
+        return;
+    }
+    
+    ready.notify_all();
+    
+    if (acceptor.joinable()) {
+        acceptor.join();
+    }
+    
+    for (std::thread& worker : pool) {
+        worker.join();
+    }
+    
+    pool.clear();
+    
+    for (int client : pending) {
+        ::close(client);
+    }
+    
+    pending.clear();
+}
+
+void Listener::accept_loop()
+{
+    while (running.load()) {
+        struct pollfd pfd;
+        pfd.fd=fd;
+        pfd.events=POLLIN;
+        
+        if (::poll(&pfd,1,LISTENER_POLL_MS)<=0) {
+            continue;
+        }
+        
+        int client=::accept(fd,nullptr,nullptr);
+        
+        if (client<0) {
+            continue;
+        }
+        
+        int one=1;
+        setsockopt(client,IPPROTO_TCP,TCP_NODELAY,&one,sizeof(one));
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(client);
+        ready.notify_one();
+    }
+}
+
+void Listener::worker_loop()
+{
+    while (true) {
+        int client;
+        
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock,[this]() {
+                return (!running.load() or pending.size()>0);
+            });
+            
+            if (!running.load()) {
+                return;
+            }
+            
+            client=pending.front();
+            pending.pop_front();
+        }
+        
+        serve(client);
+        ::close(client);
+    }
+}
+
+void Listener::set_max_body(size_t bytes)
+{
+    max_body=bytes;
+}
+
+bool Listener::receive(int client,string& buffer)
+{
+    char chunk[16384];
+    int waited=0;
+    
+    // an idle keep-alive connection may wait until stop
+    bool idle=(buffer.size()==0);
+    
+    while (running.load()) {
+        struct pollfd pfd;
+        pfd.fd=client;
+        pfd.events=POLLIN;
+        
+        int status=::poll(&pfd,1,LISTENER_POLL_MS);
+        
+        if (status<0 and errno==EINTR) {
+            continue;
+        }
+        
+        if (status==0) {
+            waited+=LISTENER_POLL_MS;
+            
+            if (!idle and waited>=LISTENER_TIMEOUT_MS) {
+                return false;
+            }
+            
+            continue;
+        }
+        
+        if (status<0) {
+            return false;
+        }
+        
+        ssize_t size=::recv(client,chunk,sizeof(chunk),0);
+        
+        if (size<=0) {
+            return false;
+        }
+        
+        buffer.append(chunk,size);
+        
+        return true;
+    }
+    
+    return false;
+}
+
+void Listener::serve(int client)
+{
+    string buffer;
+    
+    while (running.load()) {
+        size_t header_end=buffer.find("\r\n\r\n");
+        
+        if (header_end==string::npos) {
+            if (buffer.size()>LISTENER_MAX_HEADER or !receive(client,buffer)) {
+                return;
+            }
+            
+            continue;
+        }
+        
+        // request line and headers
+        string head=lower(buffer.substr(0,header_end));
+        size_t pos=head.find("\r\n");
+        
+        bool keep_alive=(head.substr(0,pos).find("http/1.1")!=string::npos);
+        size_t length=0;
+        bool expect=false;
+        
+        while (pos!=string::npos) {
+            size_t next=head.find("\r\n",pos+2);
+            string line=head.substr(pos+2,(next==string::npos) ? string::npos : next-pos-2);
+            size_t colon=line.find(':');
+            
+            if (colon!=string::npos) {
+                string key=line.substr(0,colon);
+                string value=line.substr(colon+1);
+                
+                while (value.size()>0 and value[0]==' ') {
+                    value.erase(0,1);
+                }
+                
+                if (key=="content-length") {
+                    length=std::strtoul(value.c_str(),nullptr,10);
+                }
+                
+                if (key=="connection") {
+                    keep_alive=(value.find("keep-alive")!=string::npos);
+                }
+                
+                if (key=="expect" and value.find("100-continue")!=string::npos) {
+                    expect=true;
+                }
+            }
+            
+            pos=next;
+        }
+        
+        if (length>max_body) {
+            send_all(client,"HTTP/1.1 413 Payload Too Large\r\n"
+                            "Content-Length: 0\r\n"
+                            "Connection: close\r\n\r\n");
+            return;
+        }
+        
+        if (expect) {
+            send_all(client,"HTTP/1.1 100 Continue\r\n\r\n");
+        }
+        
+        size_t body_start=header_end+4;
+        
+        while (buffer.size()<body_start+length) {
+            if (!receive(client,buffer)) {
+                return;
+            }
+        }
+        
+        string body=buffer.substr(body_start,length);
+        buffer.erase(0,body_start+length);
+        
+        string status="200 OK";
+        string response;
+        
+        try {
+            response=handler(body);
+        }
+        catch (std::exception& e) {
+            status="500 Internal Server Error";
+            response=e.what();
+        }
+        
+        string header="HTTP/1.1 "+status+"\r\n"
+                      "Content-Type: text/xml\r\n"
+                      "Content-Length: "+std::to_string(response.size())+"\r\n"
+                      "Connection: "+(keep_alive ? "keep-alive" : "close")+"\r\n\r\n";
+        
+        if (!send_all(client,header+response) or !keep_alive) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef EDUPALS_N4D_LISTENER
+#define EDUPALS_N4D_LISTENER
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+/*
+    Minimal HTTP/1.x POST listener for in-tree servers. Connections are
+    served by a fixed pool of workers, with keep-alive support
+*/
+
+#define LISTENER_MAX_BODY (64*1024*1024)
+
+namespace edupals
+{
+    namespace n4d
+    {
+        namespace http
+        {
+            /*!
+             * Gets a request body and returns response body
+            */
+            typedef std::function<std::string(const std::string&)> Handler;
+            
+            class Listener
+            {
+                public:
+                
+                Listener(Handler handler,size_t workers = 8);
+                
+                Listener(const Listener&) = delete;
+                Listener& operator=(const Listener&) = delete;
+                
+                virtual ~Listener();
+                
+                /*!
+                 * Binds a tcp socket, port 0 picks a free one.
+                 * \returns bound port
+                */
+                int listen_tcp(std::string address,int port);
+                
+                /*!
+                 * Binds a unix socket at given path
+                */
+                void listen_unix(std::string path);
+                
+                void start();
+                
+                void stop();
+                
+                /*!
+                 * Requests with a larger body are refused, 64MB by default
+                */
+                void set_max_body(size_t bytes);
+                
+                protected:
+                
+                Handler handler;
+                size_t workers;
+                size_t max_body;
+                
+                int fd;
+                std::string unix_path;
+                
+                std::atomic<bool> running;
+                std::thread acceptor;
+                std::vector<std::thread> pool;
+                
+                std::mutex mutex;
+                std::condition_variable ready;
+                std::deque<int> pending;
+                
+                void accept_loop();
+                void worker_loop();
+                void serve(int client);
+                
+                /*!
+                 * Appends bytes of a request to buffer, false once the
+                 * connection is closed, stopped or stalled
+                */
+                bool receive(int client,std::string& buffer);
+            };
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,463 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d-metrics.hpp>
+
+#include <sstream>
+#include <iomanip>
+#include <functional>
+
+using namespace edupals;
+using namespace edupals::variant;
+using namespace edupals::n4d;
+
+using namespace std;
+
+// prometheus default buckets, in microseconds
+static const int64_t le_bounds[] = {
+    100, 250, 500,
+    1000, 2500, 5000,
+    10000, 25000, 50000,
+    100000, 250000, 500000,
+    1000000, 2500000, 5000000, 10000000
+};
+
+static void atomic_max(std::atomic<int64_t>& target,int64_t value)
+{
+    int64_t current=target.load(std::memory_order_relaxed);
+    
+    while (value>current and
+           !target.compare_exchange_weak(current,value,std::memory_order_relaxed)) {
+    }
+}
+
+static string escape_label(const string& in)
+{
+    string ret;
+    
+    for (char c:in) {
+        switch (c) {
+            case '\\':
+                ret+="\\\\";
+            break;
+            
+            case '"':
+                ret+="\\\"";
+            break;
+            
+            case '\n':
+                ret+="\\n";
+            break;
+            
+            default:
+                ret+=c;
+        }
+    }
+    
+    return ret;
+}
+
+Histogram::Histogram()
+{
+    reset();
+}
+
+int Histogram::bucket(int64_t value)
+{
+    if (value<SubBuckets) {
+        return (value<0) ? 0 : value;
+    }
+    
+    int e=63-__builtin_clzll(value);
+    int index=(e-2)*SubBuckets+((value>>(e-3)) & (SubBuckets-1));
+    
+    return (index<Buckets) ? index : Buckets-1;
+}
+
+int64_t Histogram::lower_bound(int index)
+{
+    if (index<SubBuckets) {
+        return index;
+    }
+    
+    int e=index/SubBuckets+2;
+    int64_t sub=index%SubBuckets;
+    
+    return (SubBuckets+sub)<<(e-3);
+}
+
+int64_t Histogram::upper_bound(int index)
+{
+    return lower_bound(index+1)-1;
+}
+
+void Histogram::record(int64_t value)
+{
+    if (value<0) {
+        value=0;
+    }
+    
+    buckets[bucket(value)].fetch_add(1,std::memory_order_relaxed);
+    total.fetch_add(1,std::memory_order_relaxed);
+    accum.fetch_add(value,std::memory_order_relaxed);
+    atomic_max(maximum,value);
+}
+
+uint64_t Histogram::count()
+{
+    return total.load(std::memory_order_relaxed);
+}
+
+int64_t Histogram::sum()
+{
+    return accum.load(std::memory_order_relaxed);
+}
+
+int64_t Histogram::max()
+{
+    return maximum.load(std::memory_order_relaxed);
+}
+
+int64_t Histogram::percentile(double p)
+{
+    uint64_t counts[Buckets];
+    uint64_t recorded=0;
+    
+    for (int n=0;n<Buckets;n++) {
+        counts[n]=buckets[n].load(std::memory_order_relaxed);
+        recorded+=counts[n];
+    }
+    
+    if (recorded==0) {
+        return 0;
+    }
+    
+    uint64_t rank=static_cast<uint64_t>((p/100.0)*recorded+0.5);
+    
+    if (rank<1) {
+        rank=1;
+    }
+    
+    uint64_t seen=0;
+    int64_t top=max();
+    
+    for (int n=0;n<Buckets;n++) {
+        seen+=counts[n];
+        
+        if (seen>=rank) {
+            int64_t value=upper_bound(n);
+            return (value<top) ? value : top;
+        }
+    }
+    
+    return top;
+}
+
+uint64_t Histogram::count_below(int64_t value)
+{
+    uint64_t ret=0;
+    
+    for (int n=0;n<Buckets;n++) {
+        if (upper_bound(n)>value) {
+            break;
+        }
+        
+        ret+=buckets[n].load(std::memory_order_relaxed);
+    }
+    
+    return ret;
+}
+
+void Histogram::reset()
+{
+    for (int n=0;n<Buckets;n++) {
+        buckets[n].store(0,std::memory_order_relaxed);
+    }
+    
+    total.store(0,std::memory_order_relaxed);
+    accum.store(0,std::memory_order_relaxed);
+    maximum.store(0,std::memory_order_relaxed);
+}
+
+Series::Series(string name,string method) : name(name), method(method)
+{
+    calls.store(0);
+    failures.store(0);
+    in_flight.store(0);
+    request_bytes.store(0);
+    response_bytes.store(0);
+    coalesced.store(0);
+    other_errors.store(0);
+    
+    for (int n=0;n<MaxStatus;n++) {
+        status_errors[n].store(0);
+    }
+    
+    for (int n=0;n<MaxCurlCode;n++) {
+        curl_errors[n].store(0);
+    }
+}
+
+Metrics::Metrics(size_t capacity) : capacity(capacity), overflow("","")
+{
+    if (this->capacity==0) {
+        this->capacity=1;
+    }
+    
+    slots.reset(new std::atomic<Series*>[this->capacity]);
+    
+    for (size_t n=0;n<this->capacity;n++) {
+        slots[n].store(nullptr);
+    }
+    
+    running.store(0);
+}
+
+Metrics::~Metrics()
+{
+    for (size_t n=0;n<capacity;n++) {
+        delete slots[n].load();
+    }
+}
+
+Series* Metrics::find(const string& name,const string& method)
+{
+    size_t hash=std::hash<string>()(name)*31+std::hash<string>()(method);
+    
+    for (size_t n=0;n<capacity;n++) {
+        std::atomic<Series*>& slot=slots[(hash+n)%capacity];
+        Series* series=slot.load(std::memory_order_acquire);
+        
+        if (!series) {
+            Series* fresh=new Series(name,method);
+            
+            if (slot.compare_exchange_strong(series,fresh,std::memory_order_acq_rel)) {
+                return fresh;
+            }
+            
+            // someone else took the slot, series holds the winner
+            delete fresh;
+        }
+        
+        if (series->name==name and series->method==method) {
+            return series;
+        }
+    }
+    
+    return &overflow;
+}
+
+void Metrics::begin(const Trace& trace)
+{
+    running.fetch_add(1,std::memory_order_relaxed);
+    find(trace.name,trace.method)->in_flight.fetch_add(1,std::memory_order_relaxed);
+}
+
+void Metrics::end(const Trace& trace)
+{
+    running.fetch_sub(1,std::memory_order_relaxed);
+    
+    Series* series=find(trace.name,trace.method);
+    
+    series->in_flight.fetch_sub(1,std::memory_order_relaxed);
+    series->calls.fetch_add(1,std::memory_order_relaxed);
+    series->request_bytes.fetch_add(trace.request_size,std::memory_order_relaxed);
+    series->response_bytes.fetch_add(trace.response_size,std::memory_order_relaxed);
+    series->latency.record(trace.total);
+    
+    if (trace.coalesced) {
+        series->coalesced.fetch_add(1,std::memory_order_relaxed);
+    }
+    
+    if (!trace.success) {
+        series->failures.fetch_add(1,std::memory_order_relaxed);
+        
+        if (trace.curl_code>0 and trace.curl_code<Series::MaxCurlCode) {
+            series->curl_errors[trace.curl_code].fetch_add(1,std::memory_order_relaxed);
+        }
+        else {
+            if (trace.status<0 and -trace.status<Series::MaxStatus) {
+                series->status_errors[-trace.status].fetch_add(1,std::memory_order_relaxed);
+            }
+            else {
+                series->other_errors.fetch_add(1,std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+int64_t Metrics::in_flight()
+{
+    return running.load(std::memory_order_relaxed);
+}
+
+string Metrics::to_prometheus(string prefix)
+{
+    vector<Series*> all;
+    
+    for (size_t n=0;n<capacity;n++) {
+        Series* series=slots[n].load(std::memory_order_acquire);
+        
+        if (series) {
+            all.push_back(series);
+        }
+    }
+    
+    if (overflow.calls.load()>0) {
+        all.push_back(&overflow);
+    }
+    
+    stringstream out;
+    out.imbue(std::locale("C"));
+    
+    out<<"# TYPE "<<prefix<<"_calls_in_flight gauge\n";
+    out<<prefix<<"_calls_in_flight "<<in_flight()<<"\n";
+    
+    out<<"# TYPE "<<prefix<<"_calls_total counter\n";
+    for (Series* s:all) {
+        out<<prefix<<"_calls_total{plugin=\""<<escape_label(s->name)
+           <<"\",method=\""<<escape_label(s->method)<<"\"} "<<s->calls.load()<<"\n";
+    }
+    
+    out<<"# TYPE "<<prefix<<"_calls_coalesced_total counter\n";
+    for (Series* s:all) {
+        out<<prefix<<"_calls_coalesced_total{plugin=\""<<escape_label(s->name)
+           <<"\",method=\""<<escape_label(s->method)<<"\"} "<<s->coalesced.load()<<"\n";
+    }
+    
+    out<<"# TYPE "<<prefix<<"_call_errors_total counter\n";
+    for (Series* s:all) {
+        string labels="plugin=\""+escape_label(s->name)+"\",method=\""+escape_label(s->method)+"\"";
+        
+        for (int n=0;n<Series::MaxStatus;n++) {
+            uint64_t value=s->status_errors[n].load();
+            if (value>0) {
+                out<<prefix<<"_call_errors_total{"<<labels<<",kind=\"n4d\",code=\""<<-n<<"\"} "<<value<<"\n";
+            }
+        }
+        
+        for (int n=0;n<Series::MaxCurlCode;n++) {
+            uint64_t value=s->curl_errors[n].load();
+            if (value>0) {
+                out<<prefix<<"_call_errors_total{"<<labels<<",kind=\"curl\",code=\""<<n<<"\"} "<<value<<"\n";
+            }
+        }
+        
+        uint64_t value=s->other_errors.load();
+        if (value>0) {
+            out<<prefix<<"_call_errors_total{"<<labels<<",kind=\"other\",code=\"0\"} "<<value<<"\n";
+        }
+    }
+    
+    out<<"# TYPE "<<prefix<<"_request_bytes_total counter\n";
+    for (Series* s:all) {
+        out<<prefix<<"_request_bytes_total{plugin=\""<<escape_label(s->name)
+           <<"\",method=\""<<escape_label(s->method)<<"\"} "<<s->request_bytes.load()<<"\n";
+    }
+    
+    out<<"# TYPE "<<prefix<<"_response_bytes_total counter\n";
+    for (Series* s:all) {
+        out<<prefix<<"_response_bytes_total{plugin=\""<<escape_label(s->name)
+           <<"\",method=\""<<escape_label(s->method)<<"\"} "<<s->response_bytes.load()<<"\n";
+    }
+    
+    out<<"# TYPE "<<prefix<<"_call_duration_seconds histogram\n";
+    for (Series* s:all) {
+        string labels="plugin=\""+escape_label(s->name)+"\",method=\""+escape_label(s->method)+"\"";
+        
+        for (int64_t le:le_bounds) {
+            out<<prefix<<"_call_duration_seconds_bucket{"<<labels<<",le=\""
+               <<(le/1000000.0)<<"\"} "<<s->latency.count_below(le)<<"\n";
+        }
+        
+        out<<prefix<<"_call_duration_seconds_bucket{"<<labels<<",le=\"+Inf\"} "<<s->latency.count()<<"\n";
+        out<<prefix<<"_call_duration_seconds_sum{"<<labels<<"} "<<(s->latency.sum()/1000000.0)<<"\n";
+        out<<prefix<<"_call_duration_seconds_count{"<<labels<<"} "<<s->latency.count()<<"\n";
+    }
+    
+    return out.str();
+}
+
+Variant Metrics::to_variant()
+{
+    Variant ret=Variant::create_struct();
+    Variant calls=Variant::create_array(0);
+    
+    for (size_t i=0;i<=capacity;i++) {
+        Series* s=(i<capacity) ? slots[i].load(std::memory_order_acquire) : &overflow;
+        
+        if (!s or s->calls.load()==0) {
+            continue;
+        }
+        
+        Variant entry=Variant::create_struct();
+        entry["plugin"]=s->name;
+        entry["method"]=s->method;
+        entry["calls"]=static_cast<int32_t>(s->calls.load());
+        entry["failures"]=static_cast<int32_t>(s->failures.load());
+        entry["in_flight"]=static_cast<int32_t>(s->in_flight.load());
+        entry["coalesced"]=static_cast<int32_t>(s->coalesced.load());
+        entry["request_bytes"]=static_cast<double>(s->request_bytes.load());
+        entry["response_bytes"]=static_cast<double>(s->response_bytes.load());
+        
+        Variant errors=Variant::create_struct();
+        
+        for (int n=0;n<Series::MaxStatus;n++) {
+            uint64_t value=s->status_errors[n].load();
+            if (value>0) {
+                errors["n4d:"+std::to_string(-n)]=static_cast<int32_t>(value);
+            }
+        }
+        
+        for (int n=0;n<Series::MaxCurlCode;n++) {
+            uint64_t value=s->curl_errors[n].load();
+            if (value>0) {
+                errors["curl:"+std::to_string(n)]=static_cast<int32_t>(value);
+            }
+        }
+        
+        if (s->other_errors.load()>0) {
+            errors["other"]=static_cast<int32_t>(s->other_errors.load());
+        }
+        
+        entry["errors"]=errors;
+        
+        // latencies in microseconds
+        Variant latency=Variant::create_struct();
+        uint64_t count=s->latency.count();
+        latency["mean"]=(count>0) ? static_cast<double>(s->latency.sum())/count : 0.0;
+        latency["max"]=static_cast<double>(s->latency.max());
+        latency["p50"]=static_cast<double>(s->latency.percentile(50.0));
+        latency["p90"]=static_cast<double>(s->latency.percentile(90.0));
+        latency["p99"]=static_cast<double>(s->latency.percentile(99.0));
+        latency["p999"]=static_cast<double>(s->latency.percentile(99.9));
+        entry["latency"]=latency;
+        
+        calls.append(entry);
+    }
+    
+    ret["in_flight"]=static_cast<int32_t>(in_flight());
+    ret["calls"]=calls;
+    
+    return ret;
+}
@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d-mirror.hpp>
+
+#include "xmlrpc.hpp"
+
+using namespace edupals;
+using namespace edupals::variant;
+using namespace edupals::n4d;
+
+using namespace std;
+
+VariableMirror::VariableMirror(Client client) :
+    client(client), delta(true), serial(0), next_id(0)
+{
+}
+
+size_t VariableMirror::refresh()
+{
+    vector<string> changed;
+    
+    bool use_delta;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        use_delta=delta;
+    }
+    
+    if (!use_delta or !sync_changes(changed)) {
+        sync_all(changed);
+    }
+    
+    if (changed.size()>0) {
+        notify(changed);
+    }
+    
+    return changed.size();
+}
+
+Variant VariableMirror::get(const string& name)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    auto it=variables.find(name);
+    
+    if (it==variables.end()) {
+        throw exception::variable::NotFound(name);
+    }
+    
+    return it->second.value;
+}
+
+bool VariableMirror::exists(const string& name)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    return (variables.find(name)!=variables.end());
+}
+
+vector<string> VariableMirror::keys()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    vector<string> ret;
+    
+    for (auto& var : variables) {
+        ret.push_back(var.first);
+    }
+    
+    return ret;
+}
+
+Variant VariableMirror::snapshot()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Variant ret=Variant::create_struct();
+    
+    for (auto& var : variables) {
+        ret[var.first]=var.second.value;
+    }
+    
+    return ret;
+}
+
+int VariableMirror::subscribe(MirrorSubscriber subscriber)
+{
+    std::lock_guard<std::mutex> lock(subscribers_mutex);
+    
+    int id=next_id++;
+    subscribers[id]=subscriber;
+    
+    return id;
+}
+
+void VariableMirror::unsubscribe(int id)
+{
+    std::lock_guard<std::mutex> lock(subscribers_mutex);
+    subscribers.erase(id);
+}
+
+bool VariableMirror::incremental()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return delta;
+}
+
+int64_t VariableMirror::get_serial()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return serial;
+}
+
+bool VariableMirror::sync_changes(vector<string>& changed)
+{
+    int64_t since;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        since=serial;
+    }
+    
+    Variant response;
+    
+    try {
+        response=client.builtin_call("get_changes",{(int)since});
+    }
+    catch (exception::UnknownMethod& e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        delta=false;
+        return false;
+    }
+    catch (exception::Fault& e) {
+        // other faults may be transient
+        if (!e.missing("get_changes")) {
+            throw;
+        }
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        delta=false;
+        return false;
+    }
+    
+    Variant changes;
+    Variant deleted;
+    int32_t last;
+    
+    try {
+        last=(response/"serial"/variant::Type::Int32).get_int32();
+        changes=response/"changed"/variant::Type::Struct;
+        deleted=response/"deleted"/variant::Type::Array;
+    }
+    catch (variant::exception::NotFound& e) {
+        throw exception::InvalidBuiltInResponse("get_changes","missing serial, changed or deleted");
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    // server restarted, its serials are meaningless now
+    if (last<serial) {
+        serial=0;
+        return false;
+    }
+    
+    for (string& name : changes.keys()) {
+        Variant value=changes[name];
+        uint64_t hash=xmlrpc::digest(value);
+        auto it=variables.find(name);
+        
+        if (it==variables.end() or it->second.digest!=hash) {
+            variables[name]={value,hash};
+            changed.push_back(name);
+        }
+    }
+    
+    for (size_t n=0;n<deleted.count();n++) {
+        string name=deleted[n].get_string();
+        
+        if (variables.erase(name)>0) {
+            changed.push_back(name);
+        }
+    }
+    
+    serial=last;
+    
+    return true;
+}
+
+void VariableMirror::sync_all(vector<string>& changed)
+{
+    Variant all=client.get_variables();
+    map<string,Entry> fresh;
+    
+    for (string& name : all.keys()) {
+        Variant value=all[name];
+        fresh[name]={value,xmlrpc::digest(value)};
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    for (auto& var : fresh) {
+        auto it=variables.find(var.first);
+        
+        if (it==variables.end() or it->second.digest!=var.second.digest) {
+            changed.push_back(var.first);
+        }
+    }
+    
+    for (auto& var : variables) {
+        if (fresh.find(var.first)==fresh.end()) {
+            changed.push_back(var.first);
+        }
+    }
+    
+    variables.swap(fresh);
+}
+
+void VariableMirror::notify(const vector<string>& changed)
+{
+    map<int,MirrorSubscriber> current;
+    
+    {
+        std::lock_guard<std::mutex> lock(subscribers_mutex);
+        current=subscribers;
+    }
+    
+    for (auto& subscriber : current) {
+        subscriber.second(changed);
+    }
+}
@@ -0,0 +1,620 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d-mock.hpp>
+
+#include "listener.hpp"
+#include "xmlrpc.hpp"
+
+#include <sstream>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <set>
+
+using namespace edupals;
+using namespace edupals::variant;
+using namespace edupals::n4d;
+using namespace edupals::n4d::mock;
+
+using namespace std;
+
+namespace
+{
+    /*
+        Non successful N4D status, thrown while dispatching
+    */
+    class Status
+    {
+        public:
+        
+        int status;
+        int error_code;
+        string msg;
+        
+        Status(int status,int error_code=0,string msg="")
+        {
+            this->status=status;
+            this->error_code=error_code;
+            this->msg=msg;
+        }
+    };
+}
+
+static Variant envelope(int status,Variant value,string msg="",int error_code=0,string traceback="")
+{
+    Variant ret=Variant::create_struct();
+    
+    ret["status"]=status;
+    ret["msg"]=msg;
+    ret["return"]=value.none() ? Variant("") : value;
+    
+    if (status==ErrorCode::CallFailed) {
+        ret["error_code"]=error_code;
+    }
+    
+    if (status==ErrorCode::UnhandledError) {
+        ret["traceback"]=traceback;
+    }
+    
+    return ret;
+}
+
+static Variant arg(Variant& params,size_t n)
+{
+    if (n>=params.count()) {
+        throw Status(ErrorCode::InvalidArguments);
+    }
+    
+    return params[n];
+}
+
+static const set<string> builtins = {
+    "get_variable", "get_variables", "variable_exists", "set_variable",
+    "delete_variable", "get_version", "get_methods", "validate_auth",
+    "validate_user", "is_user_valid", "create_ticket", "get_ticket",
+    "get_changes", "wait_changes"
+};
+
+static string random_key()
+{
+    static const char table[]="abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    std::random_device device;
+    std::mt19937 generator(device());
+    std::uniform_int_distribution<int> dist(0,61);
+    
+    string key;
+    
+    for (int n=0;n<50;n++) {
+        key+=table[dist(generator)];
+    }
+    
+    return key;
+}
+
+Server::Server(size_t workers)
+{
+    latency.store(0);
+    payload.store(1024);
+    requests.store(0);
+    serial=0;
+    
+    listener.reset(new http::Listener([this](const string& body) {
+        return handle(body);
+    },workers));
+    
+    set_method("MockServer","echo",[](Variant args) {
+        return args;
+    });
+    
+    set_method("MockServer","payload",[this](Variant) {
+        return Variant(string(payload.load(),'x'));
+    });
+}
+
+Server::~Server()
+{
+    stop();
+}
+
+int Server::listen(int port)
+{
+    int bound=listener->listen_tcp("127.0.0.1",port);
+    url="http://127.0.0.1:"+std::to_string(bound);
+    
+    return bound;
+}
+
+void Server::listen_unix(string path)
+{
+    listener->listen_unix(path);
+}
+
+void Server::start()
+{
+    listener->start();
+}
+
+void Server::stop()
+{
+    listener->stop();
+}
+
+string Server::get_url()
+{
+    return url;
+}
+
+void Server::add_user(string name,string password,vector<string> groups)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    passwords[name]=password;
+    this->groups[name]=groups;
+}
+
+void Server::set_variable(string name,Variant value,Variant attribs)
+{
+    Variant var=Variant::create_struct();
+    
+    if (attribs.type()==variant::Type::Struct) {
+        for (string& key : attribs.keys()) {
+            var[key]=attribs[key];
+        }
+    }
+    
+    var["value"]=value;
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    variables[name]=var;
+    changes[name]=++serial;
+    changed.notify_all();
+}
+
+void Server::delete_variable(string name)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    if (variables.erase(name)>0) {
+        changes[name]=++serial;
+        changed.notify_all();
+    }
+}
+
+void Server::set_method(string plugin,string method,Method function)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    plugins[plugin][method]=function;
+}
+
+void Server::set_method(string plugin,string method,Variant value)
+{
+    set_method(plugin,method,[value](Variant) {
+        return value;
+    });
+}
+
+void Server::set_error(string plugin,string method,int status,int error_code,string msg)
+{
+    Error error;
+    error.status=status;
+    error.error_code=error_code;
+    error.msg=msg;
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    errors[plugin+"."+method]=error;
+}
+
+void Server::clear_error(string plugin,string method)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    errors.erase(plugin+"."+method);
+}
+
+void Server::set_latency(int64_t latency)
+{
+    this->latency.store(latency);
+}
+
+void Server::set_payload(size_t bytes)
+{
+    this->payload.store(bytes);
+}
+
+uint64_t Server::get_requests()
+{
+    return requests.load();
+}
+
+string Server::handle(const string& body)
+{
+    requests.fetch_add(1,std::memory_order_relaxed);
+    
+    int64_t delay=latency.load(std::memory_order_relaxed);
+    
+    if (delay>0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(delay));
+    }
+    
+    string method;
+    Variant params=xmlrpc::parse_request(body,method);
+    Variant response;
+    
+    if (method=="system.multicall") {
+        // standard xml-rpc extension, each result is wrapped into an array
+        response=Variant::create_array(0);
+        Variant calls=params.count()>0 ? params[0] : Variant::create_array(0);
+        
+        for (size_t n=0;n<calls.count();n++) {
+            string name=calls[n]["methodName"];
+            Variant call_params=calls[n]["params"];
+            Variant result=Variant::create_array(0);
+            
+            result.append(respond(name,call_params));
+            response.append(result);
+        }
+    }
+    else {
+        response=respond(method,params);
+    }
+    
+    stringstream out;
+    xmlrpc::setup(out);
+    xmlrpc::create_response(response,out);
+    
+    return out.str();
+}
+
+Variant Server::respond(string& method,Variant& params)
+{
+    Variant response;
+    
+    try {
+        response=envelope(ErrorCode::CallSuccessful,dispatch(method,params));
+    }
+    catch (Status& status) {
+        response=envelope(status.status,Variant(),status.msg,status.error_code,status.msg);
+    }
+    catch (Failure& failure) {
+        response=envelope(ErrorCode::CallFailed,Variant(),failure.msg,failure.code);
+    }
+    catch (std::exception& e) {
+        response=envelope(ErrorCode::UnhandledError,Variant(),"",0,e.what());
+    }
+    
+    return response;
+}
+
+Variant Server::changes_since(uint64_t since)
+{
+    Variant ret=Variant::create_struct();
+    Variant values=Variant::create_struct();
+    Variant deleted=Variant::create_array(0);
+    
+    for (auto& change : changes) {
+        if (change.second<=since) {
+            continue;
+        }
+        
+        auto it=variables.find(change.first);
+        
+        if (it==variables.end()) {
+            deleted.append(change.first);
+        }
+        else {
+            values[change.first]=it->second["value"];
+        }
+    }
+    
+    ret["serial"]=(int)serial;
+    ret["changed"]=values;
+    ret["deleted"]=deleted;
+    
+    return ret;
+}
+
+string Server::authenticate(Variant credential)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    if (credential.type()==variant::Type::Array and credential.count()==2) {
+        string user=credential[0];
+        string secret=credential[1];
+        
+        if (passwords.size()==0 or
+            (passwords.find(user)!=passwords.end() and passwords[user]==secret) or
+            (keys.find(user)!=keys.end() and keys[user]==secret)) {
+            return user;
+        }
+        
+        throw Status(ErrorCode::AuthenticationFailed);
+    }
+    
+    // anonymous or master key
+    if (passwords.size()==0) {
+        return "";
+    }
+    
+    if (credential.type()==variant::Type::String and credential.get_string().size()==0) {
+        return "";
+    }
+    
+    throw Status(ErrorCode::AuthenticationFailed);
+}
+
+bool Server::auth_enabled()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return (passwords.size()>0);
+}
+
+vector<string> Server::user_groups(string user)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    auto it=groups.find(user);
+    
+    if (it==groups.end()) {
+        return {};
+    }
+    
+    return it->second;
+}
+
+Variant Server::dispatch(string& method,Variant& params)
+{
+    bool is_builtin=(builtins.find(method)!=builtins.end());
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        
+        // builtins are listed as N4D plugin
+        string plugin="N4D";
+        
+        if (!is_builtin and params.count()>=2 and params[1].type()==variant::Type::String) {
+            plugin=params[1].get_string();
+        }
+        
+        auto it=errors.find(plugin+"."+method);
+        
+        if (it!=errors.end()) {
+            throw Status(it->second.status,it->second.error_code,it->second.msg);
+        }
+    }
+    
+    if (is_builtin) {
+        try {
+            return builtin(method,params);
+        }
+        catch (variant::exception::NotFound& e) {
+            throw Status(ErrorCode::InvalidArguments);
+        }
+    }
+    
+    // plugin call: credential, plugin name and arguments
+    string name=arg(params,1);
+    authenticate(arg(params,0));
+    
+    Method function;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        
+        auto plugin=plugins.find(name);
+        
+        if (plugin==plugins.end()) {
+            throw Status(ErrorCode::UnknownClass);
+        }
+        
+        auto it=plugin->second.find(method);
+        
+        if (it==plugin->second.end()) {
+            throw Status(ErrorCode::UnknownMethod);
+        }
+        
+        function=it->second;
+    }
+    
+    Variant args=Variant::create_array(0);
+    
+    for (size_t n=2;n<params.count();n++) {
+        args.append(params[n]);
+    }
+    
+    return function(args);
+}
+
+Variant Server::builtin(string& method,Variant& params)
+{
+    if (method=="get_variable") {
+        string name=arg(params,0);
+        bool attribs=(params.count()>1) ? params[1].to_boolean() : false;
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it=variables.find(name);
+        
+        if (it==variables.end()) {
+            throw Status(ErrorCode::CallFailed,VariableErrorCode::NotFound,"Variable not found");
+        }
+        
+        return attribs ? it->second : it->second["value"];
+    }
+    
+    if (method=="get_variables") {
+        bool attribs=(params.count()>0) ? params[0].to_boolean() : false;
+        Variant ret=Variant::create_struct();
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        
+        for (auto& var : variables) {
+            ret[var.first]=attribs ? var.second : var.second["value"];
+        }
+        
+        return ret;
+    }
+    
+    if (method=="variable_exists") {
+        string name=arg(params,0);
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        return (variables.find(name)!=variables.end());
+    }
+    
+    if (method=="set_variable") {
+        string user=authenticate(arg(params,0));
+        
+        if (user.size()==0 and auth_enabled()) {
+            throw Status(ErrorCode::UserNotAllowed);
+        }
+        
+        set_variable(arg(params,1),arg(params,2),(params.count()>3) ? params[3] : Variant());
+        
+        return true;
+    }
+    
+    if (method=="delete_variable") {
+        string user=authenticate(arg(params,0));
+        string name=arg(params,1);
+        
+        if (user.size()==0 and auth_enabled()) {
+            throw Status(ErrorCode::UserNotAllowed);
+        }
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        
+        if (variables.erase(name)==0) {
+            throw Status(ErrorCode::CallFailed,VariableErrorCode::NotFound,"Variable not found");
+        }
+        
+        changes[name]=++serial;
+        changed.notify_all();
+        
+        return true;
+    }
+    
+    if (method=="get_changes") {
+        int since=(params.count()>0) ? params[0].get_int32() : 0;
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        
+        return changes_since(since);
+    }
+    
+    if (method=="wait_changes") {
+        int since=arg(params,0).get_int32();
+        int timeout=(params.count()>1) ? params[1].get_int32() : 0;
+        
+        std::unique_lock<std::mutex> lock(mutex);
+        
+        changed.wait_for(lock,std::chrono::milliseconds(timeout),[this,since]() {
+            return serial>(uint64_t)since;
+        });
+        
+        return changes_since(since);
+    }
+    
+    if (method=="get_version") {
+        return "2.0-mock";
+    }
+    
+    if (method=="get_methods") {
+        Variant ret=Variant::create_struct();
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        
+        for (auto& plugin : plugins) {
+            Variant methods=Variant::create_struct();
+            
+            for (auto& m : plugin.second) {
+                methods[m.first]="";
+            }
+            
+            ret[plugin.first]=methods;
+        }
+        
+        return ret;
+    }
+    
+    if (method=="validate_auth" or method=="validate_user") {
+        Variant credential=arg(params,0);
+        
+        if (method=="validate_user") {
+            credential={arg(params,0),arg(params,1)};
+        }
+        
+        Variant ret=Variant::create_array(0);
+        Variant list=Variant::create_array(0);
+        
+        try {
+            string user=authenticate(credential);
+            
+            for (string& g : user_groups(user)) {
+                list.append(g);
+            }
+            
+            ret.append(true);
+        }
+        catch (Status& status) {
+            ret.append(false);
+        }
+        
+        ret.append(list);
+        
+        return ret;
+    }
+    
+    if (method=="is_user_valid") {
+        string user=authenticate({arg(params,0),arg(params,1)});
+        Variant wanted=arg(params,2);
+        
+        if (wanted.count()==0) {
+            return true;
+        }
+        
+        for (string& g : user_groups(user)) {
+            for (size_t n=0;n<wanted.count();n++) {
+                if (wanted[n].type()==variant::Type::String and wanted[n].get_string()==g) {
+                    return true;
+                }
+            }
+        }
+        
+        return false;
+    }
+    
+    if (method=="create_ticket") {
+        return true;
+    }
+    
+    if (method=="get_ticket") {
+        string user=authenticate({arg(params,0),arg(params,1)});
+        string key=random_key();
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        keys[user]=key;
+        
+        return key;
+    }
+    
+    return Variant();
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d.hpp>
+#include <n4d-mirror.hpp>
+#include <n4d-shm.hpp>
+#include <variant.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <csignal>
+#include <ctime>
+
+using namespace edupals;
+using namespace edupals::variant;
+using namespace edupals::n4d;
+using namespace std;
+
+/*
+    Keeps a host wide SharedCache up to date from a VariableMirror, so
+    other processes can read variables without asking the server
+*/
+
+static void usage()
+{
+    cout<<"Usage: n4d-cache [options]"<<endl;
+    cout<<"  --path PATH           cache file (default "<<EDUPALS_N4D_DEFAULT_CACHE<<")"<<endl;
+    cout<<"  --url URL             server address (default "<<EDUPALS_N4D_DEFAULT_URL<<")"<<endl;
+    cout<<"  --user USER           user name for a password credential"<<endl;
+    cout<<"  --password PASSWORD"<<endl;
+    cout<<"  --slots N             number of cached variables (default 4096)"<<endl;
+    cout<<"  --slot-size BYTES     max size of a cached variable (default 1024)"<<endl;
+    cout<<"  --interval MS         time between server checks (default 1000)"<<endl;
+    cout<<"  --timeout MS          client connect timeout"<<endl;
+}
+
+int main(int argc,char* argv[])
+{
+    string path=EDUPALS_N4D_DEFAULT_CACHE;
+    string url=EDUPALS_N4D_DEFAULT_URL;
+    string user;
+    string password;
+    size_t slots=4096;
+    size_t slot_size=1024;
+    int interval=1000;
+    int timeout=0;
+    
+    for (int n=1;n<argc;n++) {
+        string arg=argv[n];
+        
+        if (arg=="--help" or arg=="-h") {
+            usage();
+            return 0;
+        }
+        
+        if (n+1>=argc) {
+            cerr<<"Missing value for "<<arg<<endl;
+            return 1;
+        }
+        
+        string value=argv[++n];
+        
+        if (arg=="--path") {
+            path=value;
+        }
+        else if (arg=="--url") {
+            url=value;
+        }
+        else if (arg=="--user") {
+            user=value;
+        }
+        else if (arg=="--password") {
+            password=value;
+        }
+        else if (arg=="--slots") {
+            slots=std::strtoul(value.c_str(),nullptr,10);
+        }
+        else if (arg=="--slot-size") {
+            slot_size=std::strtoul(value.c_str(),nullptr,10);
+        }
+        else if (arg=="--interval") {
+            interval=std::atoi(value.c_str());
+        }
+        else if (arg=="--timeout") {
+            timeout=std::atoi(value.c_str());
+        }
+        else {
+            cerr<<"Unknown option: "<<arg<<endl;
+            usage();
+            return 1;
+        }
+    }
+    
+    if (slots==0 or interval<=0) {
+        cerr<<"slots and interval must be greater than 0"<<endl;
+        return 1;
+    }
+    
+    Client client(url);
+    
+    if (user.size()>0) {
+        client.set_credential(auth::Credential(user,password));
+    }
+    
+    if (timeout>0) {
+        client.set_timeout(timeout);
+    }
+    
+    shared_ptr<SharedCache> cache;
+    
+    try {
+        cache=std::make_shared<SharedCache>(path,slots,slot_size);
+    }
+    catch (std::exception& e) {
+        cerr<<e.what()<<endl;
+        return 1;
+    }
+    
+    // first refresh reports every variable as changed
+    VariableMirror mirror(client);
+    
+    mirror.subscribe([&](const vector<string>& changed) {
+        for (const string& name : changed) {
+            if (mirror.exists(name)) {
+                cache->update(name,mirror.get(name));
+            }
+            else {
+                cache->remove(name);
+            }
+        }
+    });
+    
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals,SIGINT);
+    sigaddset(&signals,SIGTERM);
+    pthread_sigmask(SIG_BLOCK,&signals,nullptr);
+    
+    clog<<"caching "<<url<<" variables at "<<path<<endl;
+    
+    bool failing=false;
+    
+    while (true) {
+        // changes made after this point may be missing from refresh
+        std::chrono::system_clock::time_point checked=std::chrono::system_clock::now();
+        
+        try {
+            mirror.refresh();
+            cache->touch(checked);
+            
+            if (failing) {
+                clog<<"server is back"<<endl;
+                failing=false;
+            }
+        }
+        catch (std::exception& e) {
+            // entries age out, so readers fall back to server
+            if (!failing) {
+                clog<<"refresh failed: "<<e.what()<<endl;
+                failing=true;
+            }
+        }
+        
+        struct timespec wait;
+        wait.tv_sec=interval/1000;
+        wait.tv_nsec=(interval%1000)*1000000L;
+        
+        if (sigtimedwait(&signals,nullptr,&wait)>0) {
+            break;
+        }
+    }
+    
+    clog<<"stopping, last serial "<<mirror.get_serial()<<endl;
+    
+    return 0;
+}
@@ -0,0 +1,345 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d.hpp>
+#include <n4d-metrics.hpp>
+#include <variant.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+
+using namespace edupals;
+using namespace edupals::variant;
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+enum class Operation
+{
+    Call,
+    GetVariable,
+    SetVariable,
+    ValidateAuth
+};
+
+class Options
+{
+    public:
+    
+    string url = EDUPALS_N4D_DEFAULT_URL;
+    string user;
+    string password;
+    
+    int clients = 4;
+    double qps = 0.0;
+    double duration = 10.0;
+    int timeout = EDUPALS_N4D_DEFAULT_TIMEOUT;
+    
+    string plugin = "MockServer";
+    string method = "echo";
+    string variable = "VARIABLE_0";
+    
+    map<Operation,int> mix = {
+        {Operation::Call,1},
+        {Operation::GetVariable,8},
+        {Operation::SetVariable,1},
+        {Operation::ValidateAuth,0}
+    };
+};
+
+static Options options;
+
+static n4d::Histogram latency;
+static std::atomic<uint64_t> completed(0);
+static std::atomic<uint64_t> failed(0);
+static std::atomic<uint64_t> scheduled(0);
+
+static std::mutex errors_mutex;
+static map<string,uint64_t> errors;
+
+static void usage()
+{
+    cout<<"Usage: n4d-load [options]"<<endl;
+    cout<<"  --url URL             server address (default "<<EDUPALS_N4D_DEFAULT_URL<<")"<<endl;
+    cout<<"  --user USER           user name for a password credential"<<endl;
+    cout<<"  --password PASSWORD"<<endl;
+    cout<<"  --clients M           concurrent clients (default 4)"<<endl;
+    cout<<"  --qps Q               open loop target rate, 0 runs closed loop at max throughput"<<endl;
+    cout<<"  --duration SECONDS    run time (default 10)"<<endl;
+    cout<<"  --timeout MS          client connect timeout"<<endl;
+    cout<<"  --call PLUGIN.METHOD  target of call operations (default MockServer.echo)"<<endl;
+    cout<<"  --variable NAME       target of get_variable operations (default VARIABLE_0)"<<endl;
+    cout<<"  --mix C,G,S,V         weights of call, get_variable, set_variable and"<<endl;
+    cout<<"                        validate_auth (default 1,8,1,0)"<<endl;
+}
+
+static void add_error(const string& key)
+{
+    std::lock_guard<std::mutex> lock(errors_mutex);
+    errors[key]++;
+}
+
+static void perform(n4d::Client& client,Operation op,int id,uint64_t n)
+{
+    switch (op) {
+        case Operation::Call:
+            client.call(options.plugin,options.method,{static_cast<int32_t>(n)});
+        break;
+        
+        case Operation::GetVariable:
+            client.get_variable(options.variable);
+        break;
+        
+        case Operation::SetVariable:
+            client.set_variable("N4D_LOAD_"+std::to_string(id),static_cast<int32_t>(n),Variant::create_struct());
+        break;
+        
+        case Operation::ValidateAuth:
+            client.validate_auth();
+        break;
+    }
+}
+
+static void worker(int id,Clock::time_point start,Clock::time_point end)
+{
+    n4d::Client client(options.url);
+    client.set_timeout(options.timeout);
+    
+    if (options.user.size()>0) {
+        client.set_credential(n4d::auth::Credential(options.user,options.password));
+    }
+    
+    vector<Operation> ops;
+    vector<int> weights;
+    
+    for (auto& m : options.mix) {
+        ops.push_back(m.first);
+        weights.push_back(m.second);
+    }
+    
+    std::mt19937 generator(id);
+    std::discrete_distribution<int> choose(weights.begin(),weights.end());
+    
+    uint64_t n=0;
+    
+    while (true) {
+        Clock::time_point intended=Clock::now();
+        
+        if (options.qps>0.0) {
+            /*
+                open loop: every request has a fixed slot and latency is
+                measured from it, so a stalled server is not hidden by
+                clients waiting on it
+            */
+            uint64_t slot=scheduled.fetch_add(1);
+            intended=start+std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(slot/options.qps));
+            
+            if (intended>=end) {
+                break;
+            }
+            
+            std::this_thread::sleep_until(intended);
+        }
+        else {
+            if (intended>=end) {
+                break;
+            }
+        }
+        
+        Operation op=ops[choose(generator)];
+        
+        try {
+            perform(client,op,id,n);
+        }
+        catch (n4d::exception::ServerError& e) {
+            failed.fetch_add(1);
+            add_error((e.code==0) ? "xml-rpc: "+string(e.what()) : "curl code "+std::to_string(e.code));
+        }
+        catch (n4d::exception::CallFailed& e) {
+            failed.fetch_add(1);
+            add_error("CallFailed error code "+std::to_string(e.code));
+        }
+        catch (std::exception& e) {
+            failed.fetch_add(1);
+            add_error(e.what());
+        }
+        
+        latency.record(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now()-intended).count());
+        completed.fetch_add(1);
+        n++;
+    }
+}
+
+static bool parse_options(int argc,char* argv[])
+{
+    for (int n=1;n<argc;n++) {
+        string arg=argv[n];
+        
+        if (arg=="--help" or arg=="-h") {
+            usage();
+            exit(0);
+        }
+        
+        if (n+1>=argc) {
+            cerr<<"Missing value for "<<arg<<endl;
+            return false;
+        }
+        
+        string value=argv[++n];
+        
+        if (arg=="--url") {
+            options.url=value;
+        }
+        else if (arg=="--user") {
+            options.user=value;
+        }
+        else if (arg=="--password") {
+            options.password=value;
+        }
+        else if (arg=="--clients") {
+            options.clients=std::atoi(value.c_str());
+        }
+        else if (arg=="--qps") {
+            options.qps=std::atof(value.c_str());
+        }
+        else if (arg=="--duration") {
+            options.duration=std::atof(value.c_str());
+        }
+        else if (arg=="--timeout") {
+            options.timeout=std::atoi(value.c_str());
+        }
+        else if (arg=="--call") {
+            size_t dot=value.find('.');
+            
+            if (dot==string::npos) {
+                cerr<<"Expected PLUGIN.METHOD: "<<value<<endl;
+                return false;
+            }
+            
+            options.plugin=value.substr(0,dot);
+            options.method=value.substr(dot+1);
+        }
+        else if (arg=="--variable") {
+            options.variable=value;
+        }
+        else if (arg=="--mix") {
+            Operation order[]={Operation::Call,Operation::GetVariable,Operation::SetVariable,Operation::ValidateAuth};
+            size_t pos=0;
+            
+            for (Operation op : order) {
+                options.mix[op]=std::atoi(value.c_str()+pos);
+                pos=value.find(',',pos);
+                
+                if (pos==string::npos) {
+                    pos=value.size();
+                }
+                else {
+                    pos++;
+                }
+            }
+        }
+        else {
+            cerr<<"Unknown option: "<<arg<<endl;
+            usage();
+            return false;
+        }
+    }
+    
+    int total=0;
+    
+    for (auto& m : options.mix) {
+        total+=m.second;
+    }
+    
+    if (total<=0 or options.clients<=0) {
+        cerr<<"Nothing to do"<<endl;
+        return false;
+    }
+    
+    return true;
+}
+
+int main(int argc,char* argv[])
+{
+    if (!parse_options(argc,argv)) {
+        return 1;
+    }
+    
+    clog<<"* "<<options.url<<" "<<options.clients<<" clients ";
+    
+    if (options.qps>0.0) {
+        clog<<"open loop at "<<options.qps<<" qps";
+    }
+    else {
+        clog<<"closed loop";
+    }
+    
+    clog<<" for "<<options.duration<<"s"<<endl;
+    
+    Clock::time_point start=Clock::now();
+    Clock::time_point end=start+std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(options.duration));
+    
+    vector<std::thread> threads;
+    
+    for (int n=0;n<options.clients;n++) {
+        threads.push_back(std::thread(worker,n,start,end));
+    }
+    
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    
+    double elapsed=std::chrono::duration<double>(Clock::now()-start).count();
+    
+    cout<<std::fixed<<std::setprecision(1);
+    cout<<"requests:   "<<completed.load()<<" ("<<failed.load()<<" failed)"<<endl;
+    cout<<"throughput: "<<completed.load()/elapsed<<" req/s"<<endl;
+    cout<<"latency (ms):"<<endl;
+    cout<<"    mean:   "<<((latency.count()>0) ? latency.sum()/1000.0/latency.count() : 0.0)<<endl;
+    cout<<"    p50:    "<<latency.percentile(50.0)/1000.0<<endl;
+    cout<<"    p90:    "<<latency.percentile(90.0)/1000.0<<endl;
+    cout<<"    p99:    "<<latency.percentile(99.0)/1000.0<<endl;
+    cout<<"    p999:   "<<latency.percentile(99.9)/1000.0<<endl;
+    cout<<"    max:    "<<latency.max()/1000.0<<endl;
+    
+    if (errors.size()>0) {
+        cout<<"errors:"<<endl;
+        
+        for (auto& e : errors) {
+            cout<<"    "<<e.second<<"\t"<<e.first<<endl;
+        }
+    }
+    
+    return (failed.load()>0) ? 2 : 0;
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d-mock.hpp>
+#include <variant.hpp>
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <csignal>
+
+using namespace edupals;
+using namespace edupals::variant;
+using namespace std;
+
+static void usage()
+{
+    cout<<"Usage: n4d-mock [options]"<<endl;
+    cout<<"  --port PORT           tcp port at 127.0.0.1, 0 picks a free one (default 9800)"<<endl;
+    cout<<"  --unix PATH           listen on a unix socket instead"<<endl;
+    cout<<"  --workers N           number of worker threads (default 8)"<<endl;
+    cout<<"  --latency US          delay added to every response, in microseconds"<<endl;
+    cout<<"  --payload BYTES       size of MockServer::payload() response"<<endl;
+    cout<<"  --variable NAME=VALUE adds a string variable"<<endl;
+    cout<<"  --variables N         adds N generated variables with attributes"<<endl;
+    cout<<"  --user NAME:PASSWORD  adds a valid user, otherwise any credential is valid"<<endl;
+    cout<<"  --error PLUGIN.METHOD=STATUS[:CODE]"<<endl;
+    cout<<"                        answers with given N4D status, N4D plugin for builtins"<<endl;
+}
+
+int main(int argc,char* argv[])
+{
+    n4d::mock::Server* server=nullptr;
+    int port=9800;
+    string unix_path;
+    size_t workers=8;
+    
+    // first pass, options needed to create server
+    for (int n=1;n<argc;n++) {
+        string arg=argv[n];
+        
+        if (arg=="--help" or arg=="-h") {
+            usage();
+            return 0;
+        }
+        
+        if (arg=="--workers" and n+1<argc) {
+            workers=std::strtoul(argv[n+1],nullptr,10);
+        }
+    }
+    
+    server=new n4d::mock::Server(workers);
+    
+    for (int n=1;n<argc;n++) {
+        string arg=argv[n];
+        
+        if (n+1>=argc) {
+            cerr<<"Missing value for "<<arg<<endl;
+            return 1;
+        }
+        
+        string value=argv[++n];
+        
+        if (arg=="--port") {
+            port=std::atoi(value.c_str());
+        }
+        else if (arg=="--unix") {
+            unix_path=value;
+        }
+        else if (arg=="--workers") {
+        }
+        else if (arg=="--latency") {
+            server->set_latency(std::atoll(value.c_str()));
+        }
+        else if (arg=="--payload") {
+            server->set_payload(std::strtoul(value.c_str(),nullptr,10));
+        }
+        else if (arg=="--variable") {
+            size_t eq=value.find('=');
+            
+            if (eq==string::npos) {
+                cerr<<"Expected NAME=VALUE: "<<value<<endl;
+                return 1;
+            }
+            
+            server->set_variable(value.substr(0,eq),value.substr(eq+1));
+        }
+        else if (arg=="--variables") {
+            int count=std::atoi(value.c_str());
+            
+            for (int v=0;v<count;v++) {
+                Variant attribs=Variant::create_struct();
+                attribs["description"]="Generated variable "+std::to_string(v);
+                attribs["volatile"]=false;
+                attribs["force_update"]=false;
+                
+                server->set_variable("VARIABLE_"+std::to_string(v),"value-"+std::to_string(v),attribs);
+            }
+        }
+        else if (arg=="--user") {
+            size_t colon=value.find(':');
+            
+            if (colon==string::npos) {
+                cerr<<"Expected NAME:PASSWORD: "<<value<<endl;
+                return 1;
+            }
+            
+            server->add_user(value.substr(0,colon),value.substr(colon+1),{"adm","admins","teachers"});
+        }
+        else if (arg=="--error") {
+            size_t dot=value.find('.');
+            size_t eq=value.find('=');
+            
+            if (dot==string::npos or eq==string::npos or eq<dot) {
+                cerr<<"Expected PLUGIN.METHOD=STATUS[:CODE]: "<<value<<endl;
+                return 1;
+            }
+            
+            string codes=value.substr(eq+1);
+            size_t colon=codes.find(':');
+            int status=std::atoi(codes.substr(0,colon).c_str());
+            int code=(colon==string::npos) ? 0 : std::atoi(codes.substr(colon+1).c_str());
+            
+            server->set_error(value.substr(0,dot),value.substr(dot+1,eq-dot-1),status,code);
+        }
+        else {
+            cerr<<"Unknown option: "<<arg<<endl;
+            usage();
+            return 1;
+        }
+    }
+    
+    // workers inherit this mask, so only main thread gets these signals
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals,SIGINT);
+    sigaddset(&signals,SIGTERM);
+    pthread_sigmask(SIG_BLOCK,&signals,nullptr);
+    
+    try {
+        if (unix_path.size()>0) {
+            server->listen_unix(unix_path);
+            clog<<"listening on "<<unix_path<<endl;
+        }
+        else {
+            server->listen(port);
+            clog<<"listening on "<<server->get_url()<<endl;
+        }
+        
+        server->start();
+    }
+    catch (std::exception& e) {
+        cerr<<e.what()<<endl;
+        return 1;
+    }
+    
+    int signum;
+    sigwait(&signals,&signum);
+    
+    clog<<"stopping after "<<server->get_requests()<<" requests"<<endl;
+    
+    delete server;
+    
+    return 0;
+}
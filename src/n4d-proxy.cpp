@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d.hpp>
+#include <n4d-transport.hpp>
+#include <n4d-coalesce.hpp>
+#include <variant.hpp>
+
+#include "listener.hpp"
+#include "xmlrpc.hpp"
+
+#include <sys/stat.h>
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <map>
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <csignal>
+#include <cerrno>
+
+#define EDUPALS_N4D_PROXY_SOCKET "/run/n4d-proxy.sock"
+
+using namespace edupals;
+using namespace edupals::variant;
+using namespace edupals::n4d;
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+// builtins answered from memory
+static const set<string> cacheable = {
+    "get_variable", "get_variables", "variable_exists", "get_version", "get_methods"
+};
+
+// builtins that invalidate cached variables
+static const set<string> writes = {
+    "set_variable", "delete_variable"
+};
+
+class Entry
+{
+    public:
+    
+    string response;
+    Clock::time_point expires;
+};
+
+class Proxy
+{
+    public:
+    
+    string upstream;
+    int timeout;
+    int ttl;
+    size_t max_entries;
+    
+    shared_ptr<CurlTransport> transport;
+    Coalescer coalescer;
+    
+    mutex cache_mutex;
+    map<string,Entry> cache;
+    
+    /*! bumped by each write, guarded by cache_mutex */
+    uint64_t generation;
+    
+    atomic<uint64_t> requests;
+    atomic<uint64_t> hits;
+    atomic<uint64_t> forwarded;
+    atomic<uint64_t> errors;
+    
+    Proxy(string upstream,size_t connections,int timeout,int ttl) :
+        upstream(upstream), timeout(timeout), ttl(ttl), max_entries(4096),
+        transport(std::make_shared<CurlTransport>(connections)), generation(0)
+    {
+        requests.store(0);
+        hits.store(0);
+        forwarded.store(0);
+        errors.store(0);
+    }
+    
+    string handle(const string& body);
+    
+    string forward(const string& method,const string& body);
+};
+
+static string method_name(const string& body)
+{
+    const string open="<methodName>";
+    size_t start=body.find(open);
+    
+    if (start==string::npos) {
+        return "";
+    }
+    
+    start+=open.size();
+    size_t end=body.find('<',start);
+    
+    if (end==string::npos) {
+        return "";
+    }
+    
+    return body.substr(start,end-start);
+}
+
+static string fault(const string& msg)
+{
+    stringstream out;
+    Variant value=Variant::create_struct();
+    value["faultCode"]=1;
+    value["faultString"]=msg;
+    
+    xmlrpc::setup(out);
+    out<<"<?xml version=\"1.0\"?><methodResponse><fault>";
+    xmlrpc::create_value(value,out);
+    out<<"</fault></methodResponse>";
+    
+    return out.str();
+}
+
+static bool successful(const string& response)
+{
+    try {
+        Variant value=xmlrpc::parse_response(response);
+        Variant status=value/"status"/variant::Type::Int32;
+        
+        return (status.get_int32()==ErrorCode::CallSuccessful);
+    }
+    catch (std::exception& e) {
+        return false;
+    }
+}
+
+string Proxy::forward(const string& method,const string& body)
+{
+    string response;
+    string none;
+    
+    Message message={upstream,none,method,body,timeout,nullptr,0};
+    transport->post(message,response);
+    forwarded.fetch_add(1,std::memory_order_relaxed);
+    
+    return response;
+}
+
+string Proxy::handle(const string& body)
+{
+    requests.fetch_add(1,std::memory_order_relaxed);
+    
+    string method=method_name(body);
+    bool cached=(ttl>0 and cacheable.find(method)!=cacheable.end());
+    bool write=(writes.find(method)!=writes.end());
+    uint64_t seen;
+    
+    {
+        lock_guard<mutex> lock(cache_mutex);
+        
+        // responses of reads overlapping a write are not cached
+        seen=generation;
+        
+        auto it=cached ? cache.find(body) : cache.end();
+        
+        if (it!=cache.end()) {
+            if (it->second.expires>Clock::now()) {
+                hits.fetch_add(1,std::memory_order_relaxed);
+                return it->second.response;
+            }
+            
+            cache.erase(it);
+        }
+    }
+    
+    string response;
+    
+    try {
+        if (coalescer.idempotent("N4D",method)) {
+            // credentials are part of body, so it is a safe key. Reads
+            // started before a write are not joined after it
+            string key=std::to_string(seen)+'\0'+body;
+            
+            Variant value=coalescer.run(key,[&]() {
+                return Variant(forward(method,body));
+            });
+            
+            response=value.get_string();
+        }
+        else {
+            response=forward(method,body);
+        }
+    }
+    catch (std::exception& e) {
+        errors.fetch_add(1,std::memory_order_relaxed);
+        
+        // a failed write may still have reached upstream
+        if (write) {
+            lock_guard<mutex> lock(cache_mutex);
+            generation++;
+            cache.clear();
+        }
+        
+        return fault(string("n4d-proxy: ")+e.what());
+    }
+    
+    if (write) {
+        lock_guard<mutex> lock(cache_mutex);
+        generation++;
+        cache.clear();
+    }
+    else if (cached and successful(response)) {
+        lock_guard<mutex> lock(cache_mutex);
+        
+        if (generation!=seen) {
+            return response;
+        }
+        
+        if (cache.size()>=max_entries) {
+            cache.clear();
+        }
+        
+        cache[body]={response,Clock::now()+std::chrono::milliseconds(ttl)};
+    }
+    
+    return response;
+}
+
+static void usage()
+{
+    cout<<"Usage: n4d-proxy [options]"<<endl;
+    cout<<"  --socket PATH         unix socket to listen on (default "<<EDUPALS_N4D_PROXY_SOCKET<<")"<<endl;
+    cout<<"  --upstream URL        N4D server address (default "<<EDUPALS_N4D_DEFAULT_URL<<")"<<endl;
+    cout<<"  --connections N       persistent upstream connections (default 4)"<<endl;
+    cout<<"  --workers N           local connection workers (default 32)"<<endl;
+    cout<<"  --ttl MS              lifetime of cached builtin responses, 0 disables (default 1000)"<<endl;
+    cout<<"  --timeout MS          upstream connection timeout (default "<<EDUPALS_N4D_DEFAULT_TIMEOUT<<")"<<endl;
+    cout<<"  --mode MODE           octal permissions of socket (default from umask)"<<endl;
+}
+
+int main(int argc,char* argv[])
+{
+    string socket_path=EDUPALS_N4D_PROXY_SOCKET;
+    string upstream=EDUPALS_N4D_DEFAULT_URL;
+    size_t connections=4;
+    size_t workers=32;
+    int ttl=1000;
+    int timeout=EDUPALS_N4D_DEFAULT_TIMEOUT;
+    long mode=-1;
+    
+    for (int n=1;n<argc;n++) {
+        string arg=argv[n];
+        
+        if (arg=="--help" or arg=="-h") {
+            usage();
+            return 0;
+        }
+        
+        if (n+1>=argc) {
+            cerr<<"Missing value for "<<arg<<endl;
+            return 1;
+        }
+        
+        string value=argv[++n];
+        
+        if (arg=="--socket") {
+            socket_path=value;
+        }
+        else if (arg=="--upstream") {
+            upstream=value;
+        }
+        else if (arg=="--connections") {
+            connections=std::strtoul(value.c_str(),nullptr,10);
+        }
+        else if (arg=="--workers") {
+            workers=std::strtoul(value.c_str(),nullptr,10);
+        }
+        else if (arg=="--ttl") {
+            ttl=std::atoi(value.c_str());
+        }
+        else if (arg=="--timeout") {
+            timeout=std::atoi(value.c_str());
+        }
+        else if (arg=="--mode") {
+            mode=std::strtol(value.c_str(),nullptr,8);
+        }
+        else {
+            cerr<<"Unknown option: "<<arg<<endl;
+            usage();
+            return 1;
+        }
+    }
+    
+    if (connections==0 or workers==0) {
+        cerr<<"connections and workers must be greater than 0"<<endl;
+        return 1;
+    }
+    
+    Proxy proxy(upstream,connections,timeout,ttl);
+    
+    http::Listener listener([&proxy](const string& body) {
+        return proxy.handle(body);
+    },workers);
+    
+    // workers inherit this mask, so only main thread gets these signals
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals,SIGINT);
+    sigaddset(&signals,SIGTERM);
+    pthread_sigmask(SIG_BLOCK,&signals,nullptr);
+    
+    try {
+        listener.listen_unix(socket_path);
+        
+        // anyone allowed in may write with upstream credentials
+        if (mode>=0 and chmod(socket_path.c_str(),static_cast<mode_t>(mode))!=0) {
+            throw n4d::exception::ServerError(errno,"chmod "+socket_path);
+        }
+        
+        listener.start();
+        clog<<"listening on "<<socket_path<<", upstream "<<upstream<<endl;
+    }
+    catch (std::exception& e) {
+        cerr<<e.what()<<endl;
+        return 1;
+    }
+    
+    int signum;
+    sigwait(&signals,&signum);
+    
+    listener.stop();
+    
+    clog<<"stopping after "<<proxy.requests.load()<<" requests: "
+        <<proxy.hits.load()<<" cached, "
+        <<proxy.coalescer.get_coalesced()<<" coalesced, "
+        <<proxy.forwarded.load()<<" forwarded, "
+        <<proxy.errors.load()<<" failed"<<endl;
+    
+    return 0;
+}
@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d.hpp>
+#include <n4d-record.hpp>
+#include <n4d-transport.hpp>
+#include <n4d-metrics.hpp>
+#include <variant.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <cstdlib>
+
+using namespace edupals;
+using namespace edupals::variant;
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+/*
+    Exposes Client parse and validate stages
+*/
+class ReplayClient: public n4d::Client
+{
+    public:
+    
+    using Client::parse_response;
+    using Client::validate;
+};
+
+static void usage()
+{
+    cout<<"Usage: n4d-replay [options] FILE"<<endl;
+    cout<<"  (no mode)             prints a summary of recorded traffic"<<endl;
+    cout<<"  --parse               feeds recorded responses through parse and validate"<<endl;
+    cout<<"  --repeat N            parse passes over the file (default 10)"<<endl;
+    cout<<"  --send URL            replays requests against a server"<<endl;
+    cout<<"  --speed X             pace factor, 1 original pace, 0 as fast as possible (default 1)"<<endl;
+    cout<<"  --clients M           concurrent senders (default 4)"<<endl;
+}
+
+static vector<n4d::Record> load(string path)
+{
+    vector<n4d::Record> records;
+    n4d::Player player(path);
+    n4d::Record record;
+    
+    while (player.next(record)) {
+        records.push_back(record);
+    }
+    
+    return records;
+}
+
+static void print_histogram(string title,n4d::Histogram& h)
+{
+    cout<<title<<" (ms): p50 "<<h.percentile(50.0)/1000.0
+        <<" p90 "<<h.percentile(90.0)/1000.0
+        <<" p99 "<<h.percentile(99.0)/1000.0
+        <<" max "<<h.max()/1000.0<<endl;
+}
+
+static int summary(vector<n4d::Record>& records)
+{
+    map<string,size_t> methods;
+    size_t in=0;
+    size_t out=0;
+    n4d::Histogram latency;
+    
+    for (n4d::Record& r : records) {
+        methods[r.name+"::"+r.method]++;
+        out+=r.request.size();
+        in+=r.response.size();
+        latency.record(r.duration);
+    }
+    
+    double span=0.0;
+    
+    if (records.size()>1) {
+        span=(records.back().when-records.front().when)/1000000.0;
+    }
+    
+    cout<<std::fixed<<std::setprecision(1);
+    cout<<records.size()<<" records over "<<span<<"s, "<<out<<" bytes out, "<<in<<" bytes in"<<endl;
+    print_histogram("recorded latency",latency);
+    
+    for (auto& m : methods) {
+        cout<<"    "<<m.second<<"\t"<<m.first<<endl;
+    }
+    
+    return 0;
+}
+
+static int parse(vector<n4d::Record>& records,int repeat)
+{
+    ReplayClient client;
+    size_t bytes=0;
+    size_t calls=0;
+    size_t failures=0;
+    
+    Clock::time_point start=Clock::now();
+    
+    for (int n=0;n<repeat;n++) {
+        for (n4d::Record& r : records) {
+            if (r.code!=0) {
+                continue;
+            }
+            
+            try {
+                Variant response=client.parse_response(r.response);
+                
+                if (r.name.size()>0) {
+                    client.validate(response,r.name,r.method);
+                }
+            }
+            catch (std::exception& e) {
+                failures++;
+            }
+            
+            bytes+=r.response.size();
+            calls++;
+        }
+    }
+    
+    double secs=std::chrono::duration<double>(Clock::now()-start).count();
+    
+    cout<<std::fixed<<std::setprecision(1);
+    cout<<calls<<" responses in "<<secs<<"s ("<<failures<<" with N4D errors)"<<endl;
+    cout<<"    "<<calls/secs<<" responses/s"<<endl;
+    cout<<"    "<<(bytes/secs)/(1024.0*1024.0)<<" MB/s"<<endl;
+    
+    return 0;
+}
+
+static int send(vector<n4d::Record>& records,string url,double speed,int clients)
+{
+    n4d::Histogram recorded;
+    n4d::Histogram latency;
+    std::atomic<size_t> index(0);
+    std::atomic<size_t> failures(0);
+    
+    for (n4d::Record& r : records) {
+        recorded.record(r.duration);
+    }
+    
+    Clock::time_point start=Clock::now();
+    vector<std::thread> threads;
+    
+    for (int n=0;n<clients;n++) {
+        threads.push_back(std::thread([&]() {
+            n4d::CurlTransport transport;
+            
+            while (true) {
+                size_t i=index.fetch_add(1);
+                
+                if (i>=records.size()) {
+                    break;
+                }
+                
+                n4d::Record& r=records[i];
+                
+                if (speed>0.0) {
+                    double offset=(r.when-records.front().when)/(speed*1000000.0);
+                    std::this_thread::sleep_until(start+std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::duration<double>(offset)));
+                }
+                
+                string response;
+                n4d::Message message={url,r.name,r.method,r.request,EDUPALS_N4D_DEFAULT_TIMEOUT,nullptr,0};
+                Clock::time_point sent=Clock::now();
+                
+                try {
+                    transport.post(message,response);
+                }
+                catch (std::exception& e) {
+                    failures.fetch_add(1);
+                }
+                
+                latency.record(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now()-sent).count());
+            }
+        }));
+    }
+    
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    
+    double secs=std::chrono::duration<double>(Clock::now()-start).count();
+    
+    cout<<std::fixed<<std::setprecision(1);
+    cout<<records.size()<<" requests in "<<secs<<"s ("<<failures.load()<<" failed), "
+        <<records.size()/secs<<" req/s"<<endl;
+    print_histogram("recorded",recorded);
+    print_histogram("replayed",latency);
+    
+    return (failures.load()>0) ? 2 : 0;
+}
+
+int main(int argc,char* argv[])
+{
+    string mode="summary";
+    string url;
+    string path;
+    int repeat=10;
+    int clients=4;
+    double speed=1.0;
+    
+    for (int n=1;n<argc;n++) {
+        string arg=argv[n];
+        
+        if (arg=="--help" or arg=="-h") {
+            usage();
+            return 0;
+        }
+        else if (arg=="--parse") {
+            mode="parse";
+        }
+        else if (arg=="--send" and n+1<argc) {
+            mode="send";
+            url=argv[++n];
+        }
+        else if (arg=="--repeat" and n+1<argc) {
+            repeat=std::atoi(argv[++n]);
+        }
+        else if (arg=="--speed" and n+1<argc) {
+            speed=std::atof(argv[++n]);
+        }
+        else if (arg=="--clients" and n+1<argc) {
+            clients=std::atoi(argv[++n]);
+        }
+        else if (arg.size()>0 and arg[0]!='-') {
+            path=arg;
+        }
+        else {
+            usage();
+            return 1;
+        }
+    }
+    
+    if (path.size()==0) {
+        usage();
+        return 1;
+    }
+    
+    vector<n4d::Record> records;
+    
+    try {
+        records=load(path);
+    }
+    catch (std::exception& e) {
+        cerr<<e.what()<<endl;
+        return 1;
+    }
+    
+    if (mode=="parse") {
+        return parse(records,repeat);
+    }
+    
+    if (mode=="send") {
+        return send(records,url,speed,(clients>0) ? clients : 1);
+    }
+    
+    return summary(records);
+}
@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d.hpp>
+
+#include "kernel.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <map>
+#include <set>
+#include <vector>
+#include <algorithm>
+#include <cctype>
+
+using namespace edupals;
+using namespace std;
+
+/*
+    Emits typed proxy classes for N4D plugins, from a running server or
+    from a saved introspection dump with one "Plugin method" per line
+*/
+
+static const set<string> keywords = {
+    "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor",
+    "bool", "break", "case", "catch", "char", "char16_t", "char32_t", "class",
+    "compl", "const", "constexpr", "const_cast", "continue", "decltype",
+    "default", "delete", "do", "double", "dynamic_cast", "else", "enum",
+    "explicit", "export", "extern", "false", "float", "for", "friend", "goto",
+    "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept",
+    "not", "not_eq", "nullptr", "operator", "or", "or_eq", "private",
+    "protected", "public", "register", "reinterpret_cast", "return", "short",
+    "signed", "sizeof", "static", "static_assert", "static_cast", "struct",
+    "switch", "template", "this", "thread_local", "throw", "true", "try",
+    "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual",
+    "void", "volatile", "wchar_t", "while", "xor", "xor_eq"
+};
+
+static void usage()
+{
+    cout<<"Usage: n4d-stubgen [options]"<<endl;
+    cout<<"  --url URL             introspect a running server"<<endl;
+    cout<<"  --user NAME           user for --url"<<endl;
+    cout<<"  --password PASSWORD   password for --url"<<endl;
+    cout<<"  --dump FILE           read a saved introspection dump instead"<<endl;
+    cout<<"  --save FILE           save introspection dump"<<endl;
+    cout<<"  --output FILE         generated header (default stdout)"<<endl;
+    cout<<"  --namespace NAME      namespace of generated classes (default plugins)"<<endl;
+}
+
+static string identifier(const string& name)
+{
+    string ret;
+    
+    for (char c : name) {
+        ret+=(std::isalnum((unsigned char)c) or c=='_') ? c : '_';
+    }
+    
+    if (ret.size()==0 or std::isdigit((unsigned char)ret[0])) {
+        ret="_"+ret;
+    }
+    
+    if (keywords.find(ret)!=keywords.end()) {
+        ret+="_";
+    }
+    
+    return ret;
+}
+
+// identifier not in used, colliding ones get a numeric suffix
+static string unique(const string& name,set<string>& used)
+{
+    string ret=identifier(name);
+    
+    for (int n=2;used.find(ret)!=used.end();n++) {
+        ret=identifier(name)+"_"+std::to_string(n);
+    }
+    
+    used.insert(ret);
+    
+    return ret;
+}
+
+// xml character data of a name
+static string escape(const string& value)
+{
+    string ret;
+    n4d::xmlrpc::kernel::escape(value.c_str(),value.size(),ret);
+    
+    return ret;
+}
+
+// C string literal of a xml fragment
+static string literal(const string& value)
+{
+    string ret="\"";
+    
+    for (char c : value) {
+        if (c=='"' or c=='\\') {
+            ret+='\\';
+        }
+        
+        ret+=c;
+    }
+    
+    return ret+"\"";
+}
+
+static bool load(string path,map<string,vector<string> >& plugins)
+{
+    ifstream file(path);
+    
+    if (!file) {
+        return false;
+    }
+    
+    string line;
+    
+    while (std::getline(file,line)) {
+        stringstream in(line);
+        string plugin;
+        string method;
+        
+        if (!(in>>plugin) or plugin[0]=='#' or !(in>>method)) {
+            continue;
+        }
+        
+        vector<string>& methods=plugins[plugin];
+        
+        if (std::find(methods.begin(),methods.end(),method)==methods.end()) {
+            methods.push_back(method);
+        }
+    }
+    
+    return true;
+}
+
+static void generate(ostream& out,string ns,string source,map<string,vector<string> >& plugins)
+{
+    string guard="N4D_STUBS_"+identifier(ns);
+    
+    for (char& c : guard) {
+        c=std::toupper((unsigned char)c);
+    }
+    
+    out<<"/*"<<endl;
+    out<<"    Generated by n4d-stubgen from "<<source<<", do not edit"<<endl;
+    out<<"*/"<<endl;
+    out<<endl;
+    out<<"#ifndef "<<guard<<endl;
+    out<<"#define "<<guard<<endl;
+    out<<endl;
+    out<<"#include <n4d.hpp>"<<endl;
+    out<<"#include <variant.hpp>"<<endl;
+    out<<endl;
+    out<<"namespace "<<identifier(ns)<<endl;
+    out<<"{"<<endl;
+    
+    bool first=true;
+    set<string> classes;
+    
+    for (auto& plugin : plugins) {
+        string name_param="<param><value><string>"+escape(plugin.first)+"</string></value></param>";
+        string class_name=unique(plugin.first,classes);
+        
+        // a method named after its class would be a constructor
+        set<string> methods = {class_name};
+        
+        if (class_name!=identifier(plugin.first)) {
+            cerr<<"Plugin "<<plugin.first<<" emitted as "<<class_name<<endl;
+        }
+        
+        if (!first) {
+            out<<"    "<<endl;
+        }
+        
+        first=false;
+        
+        out<<"    class "<<class_name<<endl;
+        out<<"    {"<<endl;
+        out<<"        public:"<<endl;
+        
+        for (string& method : plugin.second) {
+            string prefix="<?xml version=\"1.0\"?><methodCall><methodName>"+escape(method)+"</methodName><params>";
+            string method_name=unique(method,methods);
+            
+            if (method_name!=identifier(method)) {
+                cerr<<"Method "<<plugin.first<<"."<<method<<" emitted as "<<method_name<<endl;
+            }
+            
+            out<<"        "<<endl;
+            out<<"        template <typename R = edupals::variant::Variant,typename... Args>"<<endl;
+            out<<"        static R "<<method_name<<"(edupals::n4d::Client& client,const Args&... args)"<<endl;
+            out<<"        {"<<endl;
+            out<<"            static const edupals::n4d::typed::Method method = {"<<endl;
+            out<<"                "<<literal(plugin.first)<<","<<literal(method)<<","<<endl;
+            out<<"                "<<literal(prefix)<<","<<endl;
+            out<<"                "<<literal(name_param)<<endl;
+            out<<"            };"<<endl;
+            out<<"            "<<endl;
+            out<<"            return client.call<R>(method,args...);"<<endl;
+            out<<"        }"<<endl;
+        }
+        
+        out<<"    };"<<endl;
+    }
+    
+    out<<"}"<<endl;
+    out<<endl;
+    out<<"#endif"<<endl;
+}
+
+int main(int argc,char* argv[])
+{
+    string url;
+    string user;
+    string password;
+    string dump;
+    string save;
+    string output;
+    string ns="plugins";
+    
+    for (int n=1;n<argc;n++) {
+        string arg=argv[n];
+        
+        if (arg=="--help" or arg=="-h") {
+            usage();
+            return 0;
+        }
+        
+        if (n+1>=argc) {
+            cerr<<"Missing value for "<<arg<<endl;
+            return 1;
+        }
+        
+        string value=argv[++n];
+        
+        if (arg=="--url") {
+            url=value;
+        }
+        else if (arg=="--user") {
+            user=value;
+        }
+        else if (arg=="--password") {
+            password=value;
+        }
+        else if (arg=="--dump") {
+            dump=value;
+        }
+        else if (arg=="--save") {
+            save=value;
+        }
+        else if (arg=="--output") {
+            output=value;
+        }
+        else if (arg=="--namespace") {
+            ns=value;
+        }
+        else {
+            cerr<<"Unknown option: "<<arg<<endl;
+            usage();
+            return 1;
+        }
+    }
+    
+    if (url.size()==0 and dump.size()==0) {
+        cerr<<"Either --url or --dump is needed"<<endl;
+        return 1;
+    }
+    
+    map<string,vector<string> > plugins;
+    string source;
+    
+    if (dump.size()>0) {
+        if (!load(dump,plugins)) {
+            cerr<<"Failed to read "<<dump<<endl;
+            return 1;
+        }
+        
+        source=dump;
+    }
+    else {
+        try {
+            n4d::Client client(url,user,password);
+            plugins=client.get_methods();
+        }
+        catch (std::exception& e) {
+            cerr<<"Failed to introspect "<<url<<": "<<e.what()<<endl;
+            return 1;
+        }
+        
+        source=url;
+    }
+    
+    if (save.size()>0) {
+        ofstream file(save);
+        
+        file<<"# N4D introspection dump of "<<source<<endl;
+        
+        for (auto& plugin : plugins) {
+            for (string& method : plugin.second) {
+                file<<plugin.first<<" "<<method<<endl;
+            }
+        }
+        
+        if (!file) {
+            cerr<<"Failed to write "<<save<<endl;
+            return 1;
+        }
+    }
+    
+    if (output.size()>0) {
+        ofstream file(output);
+        generate(file,ns,source,plugins);
+        
+        if (!file) {
+            cerr<<"Failed to write "<<output<<endl;
+            return 1;
+        }
+    }
+    else {
+        generate(cout,ns,source,plugins);
+    }
+    
+    return 0;
+}
@@ -22,49 +22,47 @@
  */
 
 #include <n4d.hpp>
+#include <n4d-metrics.hpp>
+#include <n4d-slowlog.hpp>
+#include <n4d-transport.hpp>
+#include <n4d-coalesce.hpp>
+#include <n4d-writebehind.hpp>
+#include <n4d-shm.hpp>
+#include <n4d-typed.hpp>
+#include <n4d-view.hpp>
+#include <n4d-stream.hpp>
+
 #include <token.hpp>
 #include <system.hpp>
 #include <user.hpp>
 
-#include <curl/curl.h>
-#include <rapidxml/rapidxml.hpp>
+#include "probes.hpp"
+#include "xmlrpc.hpp"
+#include "stream.hpp"
 
 #include <iostream>
 #include <iomanip>
 #include <cstring>
 #include <sstream>
 #include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <thread>
+#include <mutex>
 
 using namespace edupals;
 using namespace edupals::variant;
 using namespace edupals::parser;
 using namespace edupals::n4d;
 
-using namespace rapidxml;
-
 using namespace std;
 
-class CurlFactory
-{
-    public:
-        
-    bool ready;
-    
-    CurlFactory()
-    {
-        ready = (curl_global_init(CURL_GLOBAL_ALL)==0);
-    }
-    
-    ~CurlFactory()
-    {
-        if (ready) {
-            curl_global_cleanup();
-        }
-    }
-};
+typedef std::chrono::steady_clock Clock;
 
-//TODO: check about thread safety
-CurlFactory curl_instance;
+static int64_t elapsed(Clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now()-start).count();
+}
 
 bool auth::Key::valid()
 {
@@ -206,6 +204,7 @@ string Ticket::to_string()
 
 Client::Client(string address) : timeout(EDUPALS_N4D_DEFAULT_TIMEOUT)
 {
+    this->transport=std::make_shared<CurlTransport>();
     this->address=address;
     this->flags=Option::None;
 }
@@ -216,6 +215,7 @@ Client::Client(string address,int port) : Client(address)
 
 Client::Client(string address,string user,string password) : timeout(EDUPALS_N4D_DEFAULT_TIMEOUT)
 {
+    this->transport=std::make_shared<CurlTransport>();
     this->address=address;
     this->flags=Option::None;
     
@@ -228,6 +228,7 @@ Client::Client(string address,int port,string user,string password) : Client(add
 
 Client::Client(string address,string user,auth::Key key) : timeout(EDUPALS_N4D_DEFAULT_TIMEOUT)
 {
+    this->transport=std::make_shared<CurlTransport>();
     this->address=address;
     this->flags=Option::None;
     
@@ -240,6 +241,7 @@ Client::Client(string address,int port,string user,auth::Key key) : Client(addre
 
 Client::Client(string address, auth::Credential credential) : timeout(EDUPALS_N4D_DEFAULT_TIMEOUT)
 {
+    this->transport=std::make_shared<CurlTransport>();
     this->address=address;
     this->credential=credential;
     this->flags=Option::None;
@@ -247,6 +249,7 @@ Client::Client(string address, auth::Credential credential) : timeout(EDUPALS_N4
 
 Client::Client(Ticket ticket) : timeout(EDUPALS_N4D_DEFAULT_TIMEOUT)
 {
+    this->transport=std::make_shared<CurlTransport>();
     this->address=ticket.get_address();
     this->credential=ticket.get_credential();
     this->flags=Option::None;
@@ -262,187 +265,440 @@ Client Client::from_local_ticket()
     return Client(ticket);
 }
 
-Variant parse_value(rapidxml::xml_node<>* node_value)
+Variant Client::rpc_call(string method,vector<Variant> params)
 {
-    Variant ret;
-    
-    rapidxml::xml_node<>* node = node_value->first_node();
-    
-    //nothing?
-    if (!node) {
-        return ret;
+    if (!tracing()) {
+        return rpc_call("",method,params,nullptr);
     }
     
-    string name = node->name();
-    string value = node->value();
+    Trace trace;
+    trace.method=method;
+    trace_started(trace);
     
-    if (name=="int" or name=="i4") {
-        stringstream in;
-        in.imbue(std::locale("C"));
-        in.str(value);
-        int ivalue;
-        in>>ivalue;
+    Clock::time_point start=Clock::now();
+    
+    try {
+        Variant ret=rpc_call("",method,params,&trace);
+        trace.success=true;
+        trace.total=elapsed(start);
+        trace_finished(trace);
         
-        ret=ivalue;
+        return ret;
     }
-    
-    if (name=="double") {
-        stringstream in;
-        in.imbue(std::locale("C"));
-        in.str(value);
-        double dvalue;
-        in>>dvalue;
-        ret=dvalue;
+    catch (...) {
+        trace.total=elapsed(start);
+        trace_finished(trace);
+        throw;
     }
-    
-    if (name=="boolean") {
-        stringstream in;
-        in.imbue(std::locale("C"));
-        in.str(value);
-        int ivalue;
+}
+
+Variant Client::rpc_call(const string& name,string method,vector<Variant>& params,Trace* trace)
+{
+    return send(name,method,[&](string& request) {
+        stringstream out;
         
-        in>>ivalue;
+        out.imbue(std::locale("C"));
+        out<<std::setprecision(10)<<std::fixed;
         
-        ret=(ivalue==1);
-    }
+        create_request(method,params,out);
+        request=out.str();
+    },trace);
+}
+
+Variant Client::send(const string& name,const string& method,const Serializer& serialize,Trace* trace)
+{
+    string incoming;
     
-    if (name=="string") {
-        ret=value;
+    send(name,method,serialize,trace,incoming);
+    
+    Clock::time_point start;
+    
+    if (trace) {
+        start=Clock::now();
     }
     
-    // datetime and base64 not fully supported, return as string
-    if (name=="dateTime.iso8601") {
-        ret=value;
+    Variant ret=parse_response(incoming);
+    
+    N4D_PROBE3(parse_done,name.c_str(),method.c_str(),incoming.size());
+    
+    if (trace) {
+        trace->parse=elapsed(start);
     }
     
-    if (name=="base64") {
-        ret=value;
+    return ret;
+}
+
+void Client::send(const string& name,const string& method,const Serializer& serialize,Trace* trace,string& incoming)
+{
+    Clock::time_point start;
+    
+    if (trace) {
+        start=Clock::now();
     }
     
-    if (name=="array") {
-        rapidxml::xml_node<>* node_data = node->first_node("data");
+    string request;
+    serialize(request);
+    
+    N4D_PROBE3(request_built,name.c_str(),method.c_str(),request.size());
+    
+    if (trace) {
+        trace->serialize=elapsed(start);
+        trace->request_size=request.size();
         
-        if (node_data) {
-            ret=Variant::create_array(0);
-            rapidxml::xml_node<>* node_value = node_data->first_node("value");
-            
-            while(node_value) {
-                ret.append(parse_value(node_value));
-                node_value = node_value->next_sibling("value");
-            }
+        if (trace->capture>0) {
+            trace->request=request.substr(0,trace->capture);
         }
     }
     
-    if (name=="struct") {
-        rapidxml::xml_node<>* node_member = node->first_node("member");
-        ret=Variant::create_struct();
+    if (flags & Option::Verbose) {
+        clog<<"**** OUT ****"<<endl;
+        clog<<request<<endl;
+        clog<<"*************"<<endl;
+    }
+    
+    if (coalescer and coalescer->idempotent(name,method)) {
+        string key=address+'\0'+credential.user+'\0'+credential.password+'\0'+
+                   credential.key.value+'\0'+request;
+        bool leader=false;
         
-        while (node_member) {
-            rapidxml::xml_node<>* node_name = node_member->first_node("name");
-            rapidxml::xml_node<>* node_value = node_member->first_node("value");
-            
-            if (node_name and node_value) {
-                ret[node_name->value()]=parse_value(node_value);
+        // followers get raw response and parse their own copy
+        Variant ret;
+        
+        try {
+            ret=coalescer->run(key,[&]() {
+                leader=true;
+                string response;
+                transfer(name,method,request,trace,response);
+                
+                return Variant(response);
+            });
+        }
+        catch (exception::ServerError& e) {
+            // leader trace got it from transfer
+            if (trace and !leader) {
+                trace->coalesced=true;
+                trace->curl_code=e.code;
             }
             
-            node_member=node_member->next_sibling("member");
+            throw;
+        }
+        
+        incoming=ret.get_string();
+        
+        if (trace and !leader) {
+            trace->coalesced=true;
+            trace->response_size=incoming.size();
         }
+        
+        return;
     }
     
-    return ret;
+    transfer(name,method,request,trace,incoming);
 }
 
-Variant Client::rpc_call(string method,vector<Variant> params)
+void Client::transfer(const string& name,const string& method,const string& request,Trace* trace,string& incoming)
 {
-    stringstream out;
-    stringstream in;
-    
-    out.imbue(std::locale("C"));
-    out<<std::setprecision(10)<<std::fixed;
+    Message message={address,name,method,request,timeout,trace,0};
     
-    in.imbue(std::locale("C"));
-    in<<std::setprecision(10)<<std::fixed;
+    N4D_PROBE3(post_start,name.c_str(),method.c_str(),request.size());
     
-    Variant ret;
-    
-    create_request(method,params,out);
-    
-    if (flags & Option::Verbose) {
-        clog<<"**** OUT ****"<<endl;
-        clog<<out.str()<<endl;
-        clog<<"*************"<<endl;
+    try {
+        transport->post(message,incoming);
+    }
+    catch (exception::ServerError& e) {
+        N4D_PROBE4(post_end,name.c_str(),method.c_str(),incoming.size(),static_cast<int>(e.code));
+        
+        if (trace) {
+            trace->curl_code=e.code;
+        }
+        
+        throw;
     }
     
-    post(in,out);
+    N4D_PROBE4(post_end,name.c_str(),method.c_str(),incoming.size(),0);
     
     if (flags & Option::Verbose) {
         clog<<"****  IN  ****"<<endl;
-        clog<<in.str()<<endl;
+        clog<<incoming<<endl;
         clog<<"**************"<<endl;
     }
     
-    xml_document<> doc;
-    
-    /*
-        I guess, It depends on compiler but from the theory up to three
-        input string copies are hold into memory
-    */
-    string incoming=in.str();
+    if (trace) {
+        trace->response_size=incoming.size();
+    }
+}
 
-    char* memxml=new char[incoming.size()+1];
-    std::memcpy(memxml,incoming.c_str(),incoming.size()+1);
+Variant Client::parse_response(const string& incoming)
+{
+    xmlrpc::Decoding decoding={decode_threshold,decode_threads};
     
-    try {
-        doc.parse<0>(memxml);
-    }
-    catch (rapidxml::parse_error& ex) {
-        delete [] memxml;
-        throw exception::ServerError(0,ex.what());
+    if (interning==Interning::None) {
+        return xmlrpc::parse_response(incoming,decoding);
     }
     
-    rapidxml::xml_node<>* node_method = doc.first_node("methodResponse");
+    xmlrpc::Interner local;
+    std::unique_lock<std::mutex> lock;
     
-    if (!node_method) {
-        delete [] memxml;
-        throw exception::ServerError(0,"xml-rpc: missing methodResponse node");
+    // a busy client table is not waited for
+    if (interner) {
+        lock=std::unique_lock<std::mutex>(interner->mutex,std::try_to_lock);
     }
     
-    rapidxml::xml_node<>* node_params = node_method->first_node();
+    decoding.interner=lock.owns_lock() ? interner.get() : &local;
     
-    if (!node_params) {
-        delete [] memxml;
-        throw exception::ServerError(0,"xml-rpc: missing params or fault node");
+    return xmlrpc::parse_response(incoming,decoding);
+}
+
+Variant Client::invoke(string name,string method,vector<Variant>& params)
+{
+    return invoke(name,method,[&](string& request) {
+        stringstream out;
+        
+        out.imbue(std::locale("C"));
+        out<<std::setprecision(10)<<std::fixed;
+        
+        create_request(method,params,out);
+        request=out.str();
+    });
+}
+
+Variant Client::invoke(const string& name,const string& method,const Serializer& serialize)
+{
+    if (!tracing()) {
+        Variant response=send(name,method,serialize,nullptr);
+        Variant ret;
+        
+        try {
+            ret=validate(response,name,method);
+        }
+        catch (...) {
+            N4D_PROBE3(validate_done,name.c_str(),method.c_str(),0);
+            throw;
+        }
+        
+        N4D_PROBE3(validate_done,name.c_str(),method.c_str(),1);
+        
+        return ret;
     }
     
-    string name=node_params->name();
+    Trace trace;
+    trace.name=name;
+    trace.method=method;
+    trace_started(trace);
     
-    if (name=="fault") {
-        delete [] memxml;
-        //TODO: Add fault string
-        throw exception::ServerError(0,"xml-rpc: fault response not supported");
+    Clock::time_point start=Clock::now();
+    Clock::time_point validate_start=start;
+    bool validating=false;
+    
+    try {
+        Variant response=send(name,method,serialize,&trace);
+        
+        validate_start=Clock::now();
+        validating=true;
+        
+        try {
+            Variant status=response/"status"/variant::Type::Int32;
+            trace.status=status.get_int32();
+        }
+        catch (variant::exception::NotFound& e) {
+            trace.status=ErrorCode::InvalidResponse;
+        }
+        
+        Variant ret=validate(response,name,method);
+        
+        trace.validate=elapsed(validate_start);
+        N4D_PROBE3(validate_done,name.c_str(),method.c_str(),1);
+        
+        trace.success=true;
+        trace.total=elapsed(start);
+        trace_finished(trace);
+        
+        return ret;
     }
+    catch (...) {
+        if (validating) {
+            trace.validate=elapsed(validate_start);
+            N4D_PROBE3(validate_done,name.c_str(),method.c_str(),0);
+        }
+        trace.total=elapsed(start);
+        trace_finished(trace);
+        throw;
+    }
+}
+
+void Client::begin_call(const typed::Method& method,string& request)
+{
+    request+=method.prefix;
+    request+="<param>";
+    typed::encode_variant(credential.get(),request);
+    request+="</param>";
+    request+=method.name_param;
+}
+
+void Client::invoke(const string& name,const string& method,const Serializer& serialize,const Decoder& decode)
+{
+    invoke(name,method,serialize,Viewer([&](const View& value) {
+        decode(value.node());
+    }));
+}
+
+void Client::invoke(const string& name,const string& method,const Serializer& serialize,const Viewer& view)
+{
+    Trace trace;
+    Trace* traced=nullptr;
     
-    if (name=="params") {
-        rapidxml::xml_node<>* node_param=node_params->first_node("param");
+    if (tracing()) {
+        trace.name=name;
+        trace.method=method;
+        trace_started(trace);
+        traced=&trace;
+    }
+    
+    Clock::time_point start=Clock::now();
+    bool decoding=false;
+    
+    try {
+        string incoming;
+        send(name,method,serialize,traced,incoming);
         
-        if (node_param) {
-            
-            rapidxml::xml_node<>* node_value=node_param->first_node("value");
+        Clock::time_point parse_start=Clock::now();
+        decoding=true;
+        
+        size_t size=incoming.size();
+        View response(std::move(incoming));
+        
+        View status=response["status"];
+        View ret=response["return"];
+        
+        trace.status=(status.type()==variant::Type::Int32) ? status.get_int32() : ErrorCode::InvalidResponse;
+        
+        if (trace.status!=ErrorCode::CallSuccessful or !ret.node().valid() or
+            response["msg"].type()!=variant::Type::String) {
+            // error paths are rare, go through usual validation
+            validate(response.to_variant(),name,method);
             
-            if (node_value) {
-                ret=parse_value(node_value);
-            }
+            throw exception::InvalidServerResponse(address);
+        }
+        
+        view(ret);
+        
+        N4D_PROBE3(parse_done,name.c_str(),method.c_str(),size);
+        N4D_PROBE3(validate_done,name.c_str(),method.c_str(),1);
+        
+        if (traced) {
+            trace.parse=elapsed(parse_start);
+            trace.success=true;
+            trace.total=elapsed(start);
+            trace_finished(trace);
         }
     }
+    catch (...) {
+        if (decoding) {
+            N4D_PROBE3(validate_done,name.c_str(),method.c_str(),0);
+        }
+        
+        if (traced) {
+            trace.total=elapsed(start);
+            trace_finished(trace);
+        }
+        
+        throw;
+    }
+}
+
+void Client::stream(const string& name,const string& method,const Serializer& serialize,Visitor& visitor)
+{
+    Trace trace;
+    Trace* traced=nullptr;
     
-    if (ret.none()) {
-        throw exception::ServerError(0,"xml-rpc: missing return value");
-        delete [] memxml;
+    if (tracing()) {
+        trace.name=name;
+        trace.method=method;
+        trace_started(trace);
+        traced=&trace;
     }
     
-    delete [] memxml;
+    Clock::time_point start=Clock::now();
     
-    return ret;
+    try {
+        string request;
+        serialize(request);
+        
+        N4D_PROBE3(request_built,name.c_str(),method.c_str(),request.size());
+        
+        if (traced) {
+            trace.serialize=elapsed(start);
+            trace.request_size=request.size();
+            
+            if (trace.capture>0) {
+                trace.request=request.substr(0,trace.capture);
+            }
+        }
+        
+        if (flags & Option::Verbose) {
+            clog<<"**** OUT ****"<<endl;
+            clog<<request<<endl;
+            clog<<"*************"<<endl;
+        }
+        
+        Envelope envelope(visitor);
+        xmlrpc::Reader reader(envelope);
+        size_t received=0;
+        
+        Message message={address,name,method,request,timeout,traced,0};
+        
+        N4D_PROBE3(post_start,name.c_str(),method.c_str(),request.size());
+        
+        try {
+            transport->post(message,[&](const char* data,size_t size) {
+                received+=size;
+                reader.feed(data,size);
+            });
+            
+            reader.finish();
+        }
+        catch (exception::ServerError& e) {
+            N4D_PROBE4(post_end,name.c_str(),method.c_str(),received,static_cast<int>(e.code));
+            
+            if (traced) {
+                trace.curl_code=e.code;
+            }
+            
+            throw;
+        }
+        
+        N4D_PROBE4(post_end,name.c_str(),method.c_str(),received,0);
+        
+        Variant response=envelope.response();
+        
+        if (traced) {
+            trace.response_size=received;
+            
+            try {
+                Variant status=response/"status"/variant::Type::Int32;
+                trace.status=status.get_int32();
+            }
+            catch (variant::exception::NotFound& e) {
+                trace.status=ErrorCode::InvalidResponse;
+            }
+        }
+        
+        validate(response,name,method);
+        
+        if (traced) {
+            trace.success=true;
+            trace.total=elapsed(start);
+            trace_finished(trace);
+        }
+    }
+    catch (...) {
+        if (traced) {
+            trace.total=elapsed(start);
+            trace_finished(trace);
+        }
+        
+        throw;
+    }
 }
 
 Variant Client::call(string name,string method)
@@ -453,8 +709,6 @@ Variant Client::call(string name,string method)
 
 Variant Client::call(string name,string method,vector<Variant> params)
 {
-    Variant response;
-    
     // Build N4D header
     vector<Variant> full_params;
     
@@ -469,9 +723,7 @@ Variant Client::call(string name,string method,vector<Variant> params)
         full_params.push_back(param);
     }
     
-    response=rpc_call(method,full_params);
-    
-    return validate(response,name,method);
+    return invoke(name,method,full_params);
 }
 
 Variant Client::call(string name,string method,vector<Variant> params, auth::Credential credential)
@@ -481,139 +733,119 @@ Variant Client::call(string name,string method,vector<Variant> params, auth::Cre
 
 Variant Client::builtin_call(string method,vector<Variant> params)
 {
-    Variant value = rpc_call(method,params);
-    return validate(value,"N4D",method);
+    return invoke("N4D",method,params);
 }
 
-Client::~Client()
+View Client::call_view(const string& name,const string& method,const vector<Variant>& params)
 {
+    View ret;
+    
+    invoke(name,method,[&](string& request) {
+        begin_call(name,method,request);
+        
+        for (const Variant& param : params) {
+            request+="<param>";
+            typed::encode_variant(param,request);
+            request+="</param>";
+        }
+        
+        request+="</params></methodCall>";
+    },Viewer([&](const View& value) {
+        ret=value;
+    }));
+    
+    return ret;
+}
 
+void Client::call(const string& name,const string& method,const vector<Variant>& params,Visitor& visitor)
+{
+    stream(name,method,[&](string& request) {
+        begin_call(name,method,request);
+        
+        for (const Variant& param : params) {
+            request+="<param>";
+            typed::encode_variant(param,request);
+            request+="</param>";
+        }
+        
+        request+="</params></methodCall>";
+    },visitor);
 }
 
-size_t response_cb(char *ptr, size_t size, size_t nmemb, void *userdata)
+void Client::builtin_call(const string& method,const vector<Variant>& params,Visitor& visitor)
 {
-    stringstream* in=static_cast<stringstream*>(userdata);
-    
-    for (size_t n=0;n<nmemb;n++) {
-        in->put(ptr[n]);
-    }
-    
-    return nmemb;
+    stream("N4D",method,[&](string& request) {
+        stringstream out;
+        
+        out.imbue(std::locale("C"));
+        out<<std::setprecision(10)<<std::fixed;
+        
+        create_request(method,params,out);
+        request=out.str();
+    },visitor);
 }
 
-void Client::post(stringstream& in,stringstream& out)
+View Client::builtin_view(const string& method,vector<Variant> params)
 {
-    CURL *curl;
-    CURLcode res;
-    
-    if (!curl_instance.ready) {
-        throw exception::ServerError(0,"curl_global_init");
-    }
+    View ret;
     
-    curl = curl_easy_init();
-    if(!curl) {
-        throw exception::ServerError(0,"curl_easy_init");
-    }
-    
-    curl_easy_setopt(curl, CURLOPT_URL, address.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_0);
-    
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
+    invoke("N4D",method,[&](string& request) {
+        stringstream out;
+        
+        out.imbue(std::locale("C"));
+        out<<std::setprecision(10)<<std::fixed;
+        
+        create_request(method,params,out);
+        request=out.str();
+    },Viewer([&](const View& value) {
+        ret=value;
+    }));
     
-    string data=out.str();
+    return ret;
+}
+
+void Client::begin_call(const string& name,const string& method,string& request)
+{
+    stringstream out;
     
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS,data.c_str());
+    out.imbue(std::locale("C"));
+    out<<std::setprecision(10)<<std::fixed;
     
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA,&in);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION,response_cb);
+    // same N4D header as call()
+    out<<"<?xml version=\"1.0\"?>";
+    out<<"<methodCall>";
+        out<<"<methodName>"<<method<<"</methodName>";
+        out<<"<params>";
+            out<<"<param>";
+                create_value(credential.get(),out);
+            out<<"</param>";
+            out<<"<param>";
+                create_value(name,out);
+            out<<"</param>";
+    
+    request=out.str();
+}
 
-    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, this->timeout);
-    
-    res=curl_easy_perform(curl);
+Client::~Client()
+{
+
+}
+
+void Client::post(stringstream& in,stringstream& out)
+{
+    string request=out.str();
+    string response;
+    string none;
     
-    if (res!=0) {
-        curl_easy_cleanup(curl);
-        throw exception::ServerError(res,"curl_easy_perform");
-    }
+    Message message={address,none,none,request,timeout,nullptr,0};
+    transport->post(message,response);
     
-    curl_easy_cleanup(curl);
+    in<<response;
 }
 
 void Client::create_value(Variant value, stringstream& out)
 {
-    
-    out<<"<value>";
-    switch (value.type()) {
-        
-        case variant::Type::None:
-            out<<"<nil/>";
-        break;
-            
-        case variant::Type::Boolean:
-            out<<"<boolean>";
-            if (value.get_boolean()) {
-                out<<"1";
-            }
-            else {
-                out<<"0";
-            }
-            out<<"</boolean>";
-        break;
-        
-        case variant::Type::Int32:
-            out<<"<int>";
-            out<<value.get_int32();
-            out<<"</int>";
-        break;
-        
-        // floats are encoded as doubles (losing precission)
-        case variant::Type::Float:
-            out<<"<double>";
-            out<<value.get_float();
-            out<<"</double>";
-        break;
-        
-        case variant::Type::Double:
-            out<<"<double>";
-            out<<value.get_double();
-            out<<"</double>";
-        break;
-        
-        case variant::Type::String:
-            out<<"<string>";
-            out<<value.get_string();
-            out<<"</string>";
-        break;
-        
-        case variant::Type::Array:
-            out<<"<array>";
-            out<<"<data>";
-                for(size_t n=0;n<value.count();n++) {
-                    create_value(value[n],out);
-                }
-            out<<"</data>";
-            out<<"</array>";
-        break;
-        
-        case variant::Type::Struct:
-            out<<"<struct>";
-            
-            for (string& key: value.keys()) {
-                out<<"<member>";
-                out<<"<name>";
-                out<<key;
-                out<<"</name>";
-                
-                create_value(value[key],out);
-                
-                out<<"</member>";
-            }
-            
-            out<<"</struct>";
-        break;
-    }
-    out<<"</value>";
+    xmlrpc::create_value(value,out);
 }
 
 void Client::create_request(string method,vector<Variant> params,stringstream& out)
@@ -922,6 +1154,45 @@ void Client::handle_variable_error(VariableErrorCode code, string name)
 
 Variant Client::get_variable(string name, bool attribs)
 {
+    WriteBehind::Write write;
+    
+    if (write_behind and write_behind->find(name,write)) {
+        if (write.type==WriteBehind::Type::Delete) {
+            throw exception::variable::NotFound(name);
+        }
+        
+        if (!attribs) {
+            return write.value;
+        }
+        
+        Variant full = Variant::create_struct();
+        
+        if (write.attribs.type()==variant::Type::Struct) {
+            for (string& key : write.attribs.keys()) {
+                full[key]=write.attribs[key];
+            }
+        }
+        
+        full["value"]=write.value;
+        
+        return full;
+    }
+    
+    if (shared_cache and !attribs) {
+        Variant value;
+        
+        switch (shared_cache->find(name,cache_age,value)) {
+            case SharedCache::Status::Found:
+                return value;
+            
+            case SharedCache::Status::Deleted:
+                throw exception::variable::NotFound(name);
+            
+            case SharedCache::Status::Miss:
+            break;
+        }
+    }
+    
     try {
         Variant response = builtin_call("get_variable",{name,attribs});
     
@@ -936,6 +1207,12 @@ Variant Client::get_variable(string name, bool attribs)
 
 void Client::set_variable(string name,Variant value,Variant attribs)
 {
+    if (write_behind) {
+        write_behind->push(name,{WriteBehind::Type::Set,value,attribs});
+        return;
+    }
+    
+    // own writes are read back from server until cache catches up
     try {
         Variant response = builtin_call("set_variable",{credential.get(),name,value,attribs});
     }
@@ -944,10 +1221,26 @@ void Client::set_variable(string name,Variant value,Variant attribs)
         
         throw;
     }
+    catch (...) {
+        if (shared_cache) {
+            shared_cache->invalidate(name);
+        }
+        
+        throw;
+    }
+    
+    if (shared_cache) {
+        shared_cache->invalidate(name);
+    }
 }
 
 void Client::delete_variable(string name)
 {
+    if (write_behind) {
+        write_behind->push(name,{WriteBehind::Type::Delete,Variant(),Variant()});
+        return;
+    }
+    
     try {
         Variant response = builtin_call("delete_variable",{credential.get(),name});
     }
@@ -956,13 +1249,44 @@ void Client::delete_variable(string name)
         
         throw;
     }
+    catch (...) {
+        if (shared_cache) {
+            shared_cache->invalidate(name);
+        }
+        
+        throw;
+    }
+    
+    if (shared_cache) {
+        shared_cache->invalidate(name);
+    }
 }
 
 Variant Client::get_variables(bool attribs)
 {
     try {
         Variant response = builtin_call("get_variables",{attribs});
-    
+        
+        if (write_behind and response.type()==variant::Type::Struct) {
+            Variant merged = Variant::create_struct();
+            vector<pair<string,WriteBehind::Write> > writes = write_behind->pending();
+            map<string,WriteBehind::Write> pending(writes.begin(),writes.end());
+            
+            for (string& key : response.keys()) {
+                if (pending.find(key)==pending.end()) {
+                    merged[key]=response[key];
+                }
+            }
+            
+            for (auto& w : writes) {
+                if (w.second.type==WriteBehind::Type::Set) {
+                    merged[w.first]=attribs ? get_variable(w.first,true) : w.second.value;
+                }
+            }
+            
+            return merged;
+        }
+        
         return response;
     }
     catch (exception::CallFailed& e) {
@@ -972,8 +1296,197 @@ Variant Client::get_variables(bool attribs)
     }
 }
 
+View Client::get_variable_view(const string& name,bool attribs)
+{
+    WriteBehind::Write write;
+    
+    // overlays are served by get_variable
+    if ((write_behind and write_behind->find(name,write)) or (shared_cache and !attribs)) {
+        return View(get_variable(name,attribs));
+    }
+    
+    try {
+        return builtin_view("get_variable",{name,attribs});
+    }
+    catch (exception::CallFailed& e) {
+        handle_variable_error(static_cast<VariableErrorCode>(e.code),name);
+        
+        throw;
+    }
+}
+
+View Client::get_variables_view(bool attribs)
+{
+    if (write_behind and write_behind->pending().size()>0) {
+        return View(get_variables(attribs));
+    }
+    
+    try {
+        return builtin_view("get_variables",{attribs});
+    }
+    catch (exception::CallFailed& e) {
+        handle_variable_error(static_cast<VariableErrorCode>(e.code),"");
+        
+        throw;
+    }
+}
+
+Variant Client::get_variables(const vector<string>& names,bool attribs)
+{
+    vector<string> missing;
+    
+    return get_variables(names,attribs,missing);
+}
+
+Variant Client::get_variables(const vector<string>& names,bool attribs,vector<string>& missing)
+{
+    map<string,exception_ptr> failed;
+    Variant ret = get_variables(names,attribs,missing,failed);
+    
+    if (failed.size()>0) {
+        std::rethrow_exception(failed.begin()->second);
+    }
+    
+    return ret;
+}
+
+Variant Client::get_variables(const vector<string>& names,bool attribs,vector<string>& missing,
+                              map<string,exception_ptr>& failed)
+{
+    Variant ret = Variant::create_struct();
+    vector<string> remote;
+    
+    for (const string& name : names) {
+        WriteBehind::Write write;
+        
+        if (write_behind and write_behind->find(name,write)) {
+            if (write.type==WriteBehind::Type::Delete) {
+                missing.push_back(name);
+            }
+            else {
+                ret[name]=get_variable(name,attribs);
+            }
+        }
+        else {
+            remote.push_back(name);
+        }
+    }
+    
+    if (remote.size()==0) {
+        return ret;
+    }
+    
+    if (multicall->load()) {
+        string plugin = "N4D";
+        string method = "get_variable";
+        Variant calls = Variant::create_array(0);
+        
+        for (string& name : remote) {
+            Variant call = Variant::create_struct();
+            Variant params = Variant::create_array(0);
+            
+            params.append(name);
+            params.append(attribs);
+            
+            call["methodName"]=method;
+            call["params"]=params;
+            calls.append(call);
+        }
+        
+        Variant results;
+        bool supported=true;
+        
+        try {
+            results=rpc_call("system.multicall",{calls});
+        }
+        catch (exception::Fault& e) {
+            // calls fail inside results, so only a missing multicall
+            // falls back to a full download
+            if (!e.missing("system.multicall")) {
+                throw;
+            }
+            
+            multicall->store(false);
+            supported=false;
+        }
+        
+        if (supported) {
+            if (results.type()!=variant::Type::Array or results.count()!=remote.size()) {
+                throw exception::InvalidMethodResponse(plugin,method);
+            }
+            
+            for (size_t n=0;n<remote.size();n++) {
+                Variant result=results[n];
+                
+                try {
+                    // a failed call comes as a fault struct
+                    if (result.type()==variant::Type::Struct) {
+                        xmlrpc::throw_fault(result);
+                    }
+                    
+                    if (result.type()!=variant::Type::Array or result.count()!=1) {
+                        throw exception::InvalidMethodResponse(plugin,method);
+                    }
+                    
+                    try {
+                        ret[remote[n]]=validate(result[0],plugin,method);
+                    }
+                    catch (exception::CallFailed& e) {
+                        if (e.code==VariableErrorCode::NotFound) {
+                            missing.push_back(remote[n]);
+                            continue;
+                        }
+                        
+                        handle_variable_error(static_cast<VariableErrorCode>(e.code),remote[n]);
+                        
+                        throw;
+                    }
+                }
+                catch (...) {
+                    failed[remote[n]]=std::current_exception();
+                }
+            }
+            
+            return ret;
+        }
+    }
+    
+    Variant all = get_variables(attribs);
+    map<string,bool> found;
+    
+    for (string& key : all.keys()) {
+        found[key]=true;
+    }
+    
+    for (string& name : remote) {
+        if (found.find(name)!=found.end()) {
+            ret[name]=all[name];
+        }
+        else {
+            missing.push_back(name);
+        }
+    }
+    
+    return ret;
+}
+
 bool Client::variable_exists(string name)
 {
+    WriteBehind::Write write;
+    
+    if (write_behind and write_behind->find(name,write)) {
+        return (write.type==WriteBehind::Type::Set);
+    }
+    
+    if (shared_cache) {
+        Variant value;
+        SharedCache::Status status=shared_cache->find(name,cache_age,value);
+        
+        if (status!=SharedCache::Status::Miss) {
+            return (status==SharedCache::Status::Found);
+        }
+    }
+    
     try {
         Variant response = builtin_call("variable_exists",{name});
     
@@ -1011,6 +1524,7 @@ string Client::version()
 void Client::set_flags(int flags)
 {
     this->flags=flags;
+    update_write_behind();
 }
 
 int Client::get_flags()
@@ -1021,6 +1535,7 @@ int Client::get_flags()
 void Client::set_credential(auth::Credential credential)
 {
     this->credential=credential;
+    update_write_behind();
 }
 
 auth::Credential Client::get_credential()
@@ -1036,6 +1551,8 @@ string Client::get_address()
 void Client::set_address(string address)
 {
     this->address=address;
+    multicall=std::make_shared<std::atomic<bool> >(true);
+    update_write_behind();
 }
 
 int Client::get_timeout()
@@ -1046,4 +1563,159 @@ int Client::get_timeout()
 void Client::set_timeout(int ms)
 {
     this->timeout = ms;
+    update_write_behind();
+}
+
+bool Client::tracing()
+{
+    return (trace_sink or metrics or slow_log);
+}
+
+void Client::trace_started(Trace& trace)
+{
+    if (metrics) {
+        metrics->begin(trace);
+    }
+    
+    if (slow_log and slow_log->sample()) {
+        trace.capture=slow_log->get_capture();
+    }
+}
+
+void Client::trace_finished(Trace& trace)
+{
+    if (metrics) {
+        metrics->end(trace);
+    }
+    
+    if (slow_log) {
+        slow_log->push(trace);
+    }
+    
+    if (trace_sink) {
+        trace_sink(trace);
+    }
+}
+
+void Client::set_trace_sink(TraceSink sink)
+{
+    this->trace_sink=sink;
+    update_write_behind();
+}
+
+
+void Client::set_metrics(shared_ptr<Metrics> metrics)
+{
+    this->metrics=metrics;
+    update_write_behind();
+}
+
+shared_ptr<Metrics> Client::get_metrics()
+{
+    return metrics;
+}
+
+void Client::set_slow_log(shared_ptr<SlowLog> slow_log)
+{
+    this->slow_log=slow_log;
+    update_write_behind();
+}
+
+shared_ptr<SlowLog> Client::get_slow_log()
+{
+    return slow_log;
+}
+
+void Client::set_transport(shared_ptr<Transport> transport)
+{
+    this->transport=transport;
+    update_write_behind();
+}
+
+shared_ptr<Transport> Client::get_transport()
+{
+    return transport;
+}
+
+void Client::set_coalescer(shared_ptr<Coalescer> coalescer)
+{
+    this->coalescer=coalescer;
+    update_write_behind();
+}
+
+shared_ptr<Coalescer> Client::get_coalescer()
+{
+    return coalescer;
+}
+
+void Client::set_write_behind(size_t max_pending,int interval)
+{
+    // previous queue is flushed on destruction
+    write_behind.reset();
+    
+    if (max_pending>0) {
+        write_behind=std::make_shared<WriteBehind>(*this,max_pending,interval);
+    }
+}
+
+shared_ptr<WriteBehind> Client::get_write_behind()
+{
+    return write_behind;
+}
+
+void Client::update_write_behind()
+{
+    if (!write_behind) {
+        return;
+    }
+    
+    // sender copy must not queue its own writes
+    Client sender=*this;
+    sender.write_behind.reset();
+    
+    write_behind->set_sender(sender);
 }
+
+void Client::set_shared_cache(shared_ptr<SharedCache> cache,int max_age)
+{
+    shared_cache=cache;
+    cache_age=max_age;
+    update_write_behind();
+}
+
+shared_ptr<SharedCache> Client::get_shared_cache()
+{
+    return shared_cache;
+}
+
+void Client::set_interning(Interning scope)
+{
+    interning=scope;
+    interner.reset();
+    
+    if (scope==Interning::Client) {
+        interner=std::make_shared<xmlrpc::Interner>();
+    }
+    
+    update_write_behind();
+}
+
+void Client::set_parallel_decoding(size_t threshold,size_t threads)
+{
+    if (threads==0) {
+        threads=std::thread::hardware_concurrency();
+    }
+    
+    decode_threshold=threshold;
+    decode_threads=threads;
+    update_write_behind();
+}
+
+map<string,exception_ptr> Client::flush()
+{
+    if (!write_behind) {
+        return map<string,exception_ptr>();
+    }
+    
+    return write_behind->flush();
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef EDUPALS_N4D_PROBES
+#define EDUPALS_N4D_PROBES
+
+/*
+    USDT probes at call pipeline boundaries, under provider edupals_n4d:
+    
+    request_built(plugin, method, request size)
+    post_start(plugin, method, request size)
+    first_byte(plugin, method, first chunk size)
+    post_end(plugin, method, response size, curl code)
+    parse_done(plugin, method, response size)
+    validate_done(plugin, method, accepted)
+    
+    Probes are only built with ENABLE_USDT, otherwise arguments are not even
+    evaluated.
+*/
+
+#ifdef EDUPALS_N4D_USDT
+
+#include <sys/sdt.h>
+
+#define N4D_PROBE3(name,a,b,c) DTRACE_PROBE3(edupals_n4d,name,a,b,c)
+#define N4D_PROBE4(name,a,b,c,d) DTRACE_PROBE4(edupals_n4d,name,a,b,c,d)
+
+#else
+
+// sizeof keeps locals only passed to probes from being unused
+#define N4D_PROBE3(name,a,b,c) do { (void)sizeof(a); (void)sizeof(b); (void)sizeof(c); } while (0)
+#define N4D_PROBE4(name,a,b,c,d) do { (void)sizeof(a); (void)sizeof(b); (void)sizeof(c); (void)sizeof(d); } while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d-record.hpp>
+
+#include <cstring>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace edupals;
+using namespace edupals::n4d;
+
+using namespace std;
+
+/*
+    File starts with a magic string followed by records:
+    
+    u32 size of the rest of the record
+    i64 when
+    i64 duration
+    i32 code
+    u32 name, method, request and response lengths
+    name, method, request and response bytes
+    
+    Integers are stored little endian
+*/
+
+#define RECORD_MAGIC "N4DREC1\n"
+#define RECORD_HEADER 36
+
+typedef std::chrono::steady_clock Clock;
+
+static void put(string& out,uint64_t value,int bytes)
+{
+    for (int n=0;n<bytes;n++) {
+        out+=static_cast<char>((value>>(n*8)) & 0xff);
+    }
+}
+
+static uint64_t get(const char* in,int bytes)
+{
+    uint64_t value=0;
+    
+    for (int n=0;n<bytes;n++) {
+        value|=static_cast<uint64_t>(static_cast<uint8_t>(in[n]))<<(n*8);
+    }
+    
+    return value;
+}
+
+Recorder::Recorder(string path)
+{
+    fd=::open(path.c_str(),O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,0600);
+    
+    if (fd<0) {
+        throw exception::ServerError(errno,"can not open "+path);
+    }
+    
+    if (::lseek(fd,0,SEEK_END)==0) {
+        if (::write(fd,RECORD_MAGIC,std::strlen(RECORD_MAGIC))<0) {
+            throw exception::ServerError(errno,"can not write "+path);
+        }
+    }
+}
+
+Recorder::~Recorder()
+{
+    ::close(fd);
+}
+
+void Recorder::write(const Record& record)
+{
+    size_t size=RECORD_HEADER+record.name.size()+record.method.size()+
+                record.request.size()+record.response.size();
+    
+    string data;
+    data.reserve(size+4);
+    
+    put(data,size,4);
+    put(data,record.when,8);
+    put(data,record.duration,8);
+    put(data,record.code,4);
+    put(data,record.name.size(),4);
+    put(data,record.method.size(),4);
+    put(data,record.request.size(),4);
+    put(data,record.response.size(),4);
+    
+    data+=record.name;
+    data+=record.method;
+    data+=record.request;
+    data+=record.response;
+    
+    // O_APPEND single write keeps records whole among writers
+    size_t written=0;
+    
+    while (written<data.size()) {
+        ssize_t status=::write(fd,data.c_str()+written,data.size()-written);
+        
+        if (status<0) {
+            if (errno==EINTR) {
+                continue;
+            }
+            
+            throw exception::ServerError(errno,"traffic record write");
+        }
+        
+        written+=status;
+    }
+}
+
+Player::Player(string path) : file(path,std::ios::binary)
+{
+    if (!file) {
+        throw exception::ServerError(0,"can not open "+path);
+    }
+    
+    rewind();
+}
+
+void Player::rewind()
+{
+    file.clear();
+    file.seekg(0);
+    
+    char magic[8];
+    file.read(magic,8);
+    
+    if (!file or std::memcmp(magic,RECORD_MAGIC,8)!=0) {
+        throw exception::ServerError(0,"not a traffic file");
+    }
+}
+
+bool Player::next(Record& record)
+{
+    char header[RECORD_HEADER+4];
+    
+    file.read(header,sizeof(header));
+    
+    if (!file) {
+        return false;
+    }
+    
+    size_t size=get(header,4);
+    record.when=get(header+4,8);
+    record.duration=get(header+12,8);
+    record.code=static_cast<int32_t>(get(header+20,4));
+    
+    size_t lengths[4];
+    
+    for (int n=0;n<4;n++) {
+        lengths[n]=get(header+24+n*4,4);
+    }
+    
+    if (size!=RECORD_HEADER+lengths[0]+lengths[1]+lengths[2]+lengths[3]) {
+        throw exception::ServerError(0,"corrupted traffic record");
+    }
+    
+    string* fields[4]={&record.name,&record.method,&record.request,&record.response};
+    
+    for (int n=0;n<4;n++) {
+        fields[n]->resize(lengths[n]);
+        
+        if (lengths[n]>0) {
+            file.read(&(*fields[n])[0],lengths[n]);
+        }
+    }
+    
+    // a truncated last record is ignored
+    return static_cast<bool>(file);
+}
+
+RecordingTransport::RecordingTransport(shared_ptr<Transport> transport,shared_ptr<Recorder> recorder) :
+    transport(transport), recorder(recorder)
+{
+}
+
+void RecordingTransport::post(const Message& message,string& response)
+{
+    Record record;
+    record.when=std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    record.code=0;
+    record.name=message.name;
+    record.method=message.method;
+    record.request=message.request;
+    
+    Clock::time_point start=Clock::now();
+    
+    try {
+        transport->post(message,response);
+    }
+    catch (exception::ServerError& e) {
+        record.duration=std::chrono::duration_cast<std::chrono::microseconds>(Clock::now()-start).count();
+        record.code=(e.code!=0) ? e.code : -1;
+        record.response=response;
+        recorder->write(record);
+        
+        throw;
+    }
+    
+    record.duration=std::chrono::duration_cast<std::chrono::microseconds>(Clock::now()-start).count();
+    record.response=response;
+    recorder->write(record);
+}
@@ -0,0 +1,478 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d-shm.hpp>
+
+#include "xmlrpc.hpp"
+
+#include <rapidxml/rapidxml.hpp>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
+#include <vector>
+#include <algorithm>
+
+using namespace edupals;
+using namespace edupals::variant;
+using namespace edupals::n4d;
+
+using namespace std;
+
+/*
+    layout:
+    header: magic[8] slots:u64 slot_size:u64 touched:i64, padded to 64 bytes
+    slot: seq:u32 flags:u32 hash:u64 updated:i64 name_size:u32 data_size:u32
+          name data
+*/
+
+static const char magic[8]={'N','4','D','S','H','M','1','\0'};
+
+#define HEADER_SIZE 64
+#define SLOT_HEADER 32
+#define MAX_PROBE 32
+#define MAX_RETRY 64
+
+namespace
+{
+    enum Flags
+    {
+        Empty = 0,
+        Present = 1,
+        Deleted = 2,
+        Uncached = 3
+    };
+    
+    class Slot
+    {
+        public:
+        
+        std::atomic<uint32_t> seq;
+        uint32_t flags;
+        uint64_t hash;
+        int64_t updated;
+        uint32_t name_size;
+        uint32_t data_size;
+    };
+}
+
+static_assert(sizeof(Slot)==SLOT_HEADER,"unexpected slot header size");
+
+static uint64_t hash_name(const string& name)
+{
+    uint64_t hash=14695981039346656037ULL;
+    
+    for (char c : name) {
+        hash^=(unsigned char)c;
+        hash*=1099511628211ULL;
+    }
+    
+    return hash;
+}
+
+static int64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static string error_string()
+{
+    return std::strerror(errno);
+}
+
+SharedCache::SharedCache(string path) : path(path), writable(false), memory(nullptr), size(0)
+{
+    int fd=open(path.c_str(),O_RDONLY);
+    
+    if (fd<0) {
+        throw exception::CacheError(path,error_string());
+    }
+    
+    struct stat info;
+    uint8_t header[HEADER_SIZE];
+    
+    if (fstat(fd,&info)<0 or info.st_size<HEADER_SIZE or
+        pread(fd,header,HEADER_SIZE,0)!=HEADER_SIZE or
+        std::memcmp(header,magic,sizeof(magic))!=0) {
+        close(fd);
+        throw exception::CacheError(path,"not a variable cache");
+    }
+    
+    uint64_t value;
+    std::memcpy(&value,header+8,8);
+    slots=value;
+    std::memcpy(&value,header+16,8);
+    slot_size=value;
+    
+    size=HEADER_SIZE+slots*slot_size;
+    
+    if (slot_size<=SLOT_HEADER or (size_t)info.st_size<size) {
+        close(fd);
+        throw exception::CacheError(path,"truncated cache");
+    }
+    
+    void* ptr=mmap(nullptr,size,PROT_READ,MAP_SHARED,fd,0);
+    close(fd);
+    
+    if (ptr==MAP_FAILED) {
+        throw exception::CacheError(path,error_string());
+    }
+    
+    memory=static_cast<uint8_t*>(ptr);
+}
+
+SharedCache::SharedCache(string path,size_t slots,size_t slot_size) :
+    path(path), writable(true), memory(nullptr), slots(slots)
+{
+    // keep slots 8 bytes aligned
+    this->slot_size=((std::max(slot_size,(size_t)SLOT_HEADER*2)+7)/8)*8;
+    size=HEADER_SIZE+this->slots*this->slot_size;
+    
+    if (slots==0) {
+        throw exception::CacheError(path,"no slots");
+    }
+    
+    int fd=open(path.c_str(),O_RDWR | O_CREAT,0644);
+    
+    if (fd<0) {
+        throw exception::CacheError(path,error_string());
+    }
+    
+    struct stat info;
+    uint8_t header[HEADER_SIZE]={0};
+    bool reuse=false;
+    
+    if (fstat(fd,&info)==0 and (size_t)info.st_size==size and
+        pread(fd,header,HEADER_SIZE,0)==HEADER_SIZE and
+        std::memcmp(header,magic,sizeof(magic))==0) {
+        uint64_t a,b;
+        std::memcpy(&a,header+8,8);
+        std::memcpy(&b,header+16,8);
+        reuse=(a==this->slots and b==this->slot_size);
+    }
+    
+    if (!reuse) {
+        // readers may have current file mapped, replace it instead of
+        // resizing under them
+        close(fd);
+        
+        string tmp=path+".tmp";
+        fd=open(tmp.c_str(),O_RDWR | O_CREAT | O_TRUNC,0644);
+        
+        if (fd<0) {
+            throw exception::CacheError(tmp,error_string());
+        }
+        
+        uint64_t a=this->slots;
+        uint64_t b=this->slot_size;
+        
+        std::memset(header,0,HEADER_SIZE);
+        std::memcpy(header,magic,sizeof(magic));
+        std::memcpy(header+8,&a,8);
+        std::memcpy(header+16,&b,8);
+        
+        if (ftruncate(fd,size)<0 or pwrite(fd,header,HEADER_SIZE,0)!=HEADER_SIZE or
+            rename(tmp.c_str(),path.c_str())<0) {
+            string info=error_string();
+            close(fd);
+            unlink(tmp.c_str());
+            throw exception::CacheError(path,info);
+        }
+    }
+    
+    void* ptr=mmap(nullptr,size,PROT_READ | PROT_WRITE,MAP_SHARED,fd,0);
+    close(fd);
+    
+    if (ptr==MAP_FAILED) {
+        throw exception::CacheError(path,error_string());
+    }
+    
+    memory=static_cast<uint8_t*>(ptr);
+}
+
+SharedCache::~SharedCache()
+{
+    if (memory) {
+        munmap(memory,size);
+    }
+}
+
+std::atomic<int64_t>* SharedCache::touched_at()
+{
+    return reinterpret_cast<std::atomic<int64_t>*>(memory+24);
+}
+
+uint8_t* SharedCache::slot(size_t n)
+{
+    return memory+HEADER_SIZE+n*slot_size;
+}
+
+SharedCache::Status SharedCache::find(const string& name,int max_age,Variant& value)
+{
+    uint64_t hash=hash_name(name);
+    size_t probe=std::min(slots,(size_t)MAX_PROBE);
+    size_t capacity=slot_size-SLOT_HEADER;
+    
+    string key;
+    string data;
+    
+    for (size_t n=0;n<probe;n++) {
+        uint8_t* ptr=slot((hash+n)%slots);
+        Slot* header=reinterpret_cast<Slot*>(ptr);
+        
+        uint32_t flags;
+        int64_t updated;
+        bool consistent=false;
+        
+        for (int retry=0;retry<MAX_RETRY;retry++) {
+            uint32_t seq=header->seq.load(std::memory_order_acquire);
+            
+            if (seq & 1) {
+                continue;
+            }
+            
+            flags=header->flags;
+            updated=header->updated;
+            uint64_t slot_hash=header->hash;
+            uint32_t name_size=header->name_size;
+            uint32_t data_size=header->data_size;
+            
+            key.clear();
+            data.clear();
+            
+            if (flags!=Flags::Empty and slot_hash==hash and
+                (size_t)name_size+data_size<=capacity) {
+                key.assign((const char*)ptr+SLOT_HEADER,name_size);
+                data.assign((const char*)ptr+SLOT_HEADER+name_size,data_size);
+            }
+            
+            std::atomic_thread_fence(std::memory_order_acquire);
+            
+            if (header->seq.load(std::memory_order_relaxed)==seq) {
+                consistent=true;
+                break;
+            }
+        }
+        
+        // writer keeps slot busy, just ask server
+        if (!consistent) {
+            return Status::Miss;
+        }
+        
+        if (flags==Flags::Empty) {
+            return Status::Miss;
+        }
+        
+        if (key!=name) {
+            continue;
+        }
+        
+        int64_t touched=touched_at()->load(std::memory_order_acquire);
+        int64_t current=std::max(updated,touched);
+        
+        if (now()-current>(int64_t)max_age*1000) {
+            return Status::Miss;
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(written_mutex);
+            
+            auto it=written.find(name);
+            
+            if (it!=written.end()) {
+                if (current<=it->second) {
+                    return Status::Miss;
+                }
+                
+                written.erase(it);
+            }
+        }
+        
+        if (flags==Flags::Uncached) {
+            return Status::Miss;
+        }
+        
+        if (flags==Flags::Deleted) {
+            return Status::Deleted;
+        }
+        
+        vector<char> buffer(data.begin(),data.end());
+        buffer.push_back(0);
+        
+        rapidxml::xml_document<> doc;
+        
+        try {
+            doc.parse<0>(buffer.data());
+        }
+        catch (rapidxml::parse_error& e) {
+            return Status::Miss;
+        }
+        
+        rapidxml::xml_node<>* node=doc.first_node("value");
+        
+        if (!node) {
+            return Status::Miss;
+        }
+        
+        value=xmlrpc::parse_value(node);
+        
+        return Status::Found;
+    }
+    
+    return Status::Miss;
+}
+
+size_t SharedCache::locate(const string& name,uint64_t hash)
+{
+    size_t probe=std::min(slots,(size_t)MAX_PROBE);
+    
+    for (size_t n=0;n<probe;n++) {
+        size_t index=(hash+n)%slots;
+        Slot* header=reinterpret_cast<Slot*>(slot(index));
+        
+        if (header->flags==Flags::Empty) {
+            return index;
+        }
+        
+        if (header->hash==hash and header->name_size==name.size() and
+            std::memcmp(slot(index)+SLOT_HEADER,name.c_str(),name.size())==0) {
+            return index;
+        }
+    }
+    
+    return slots;
+}
+
+void SharedCache::write(const string& name,uint32_t flags,const string& data)
+{
+    if (!writable) {
+        throw exception::CacheError(path,"opened read only");
+    }
+    
+    uint64_t hash=hash_name(name);
+    size_t index=locate(name,hash);
+    
+    if (index==slots) {
+        return;
+    }
+    
+    uint8_t* ptr=slot(index);
+    Slot* header=reinterpret_cast<Slot*>(ptr);
+    
+    uint32_t seq=header->seq.load(std::memory_order_relaxed);
+    header->seq.store(seq+1,std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    
+    header->flags=flags;
+    header->hash=hash;
+    header->updated=now();
+    header->name_size=name.size();
+    header->data_size=data.size();
+    std::memcpy(ptr+SLOT_HEADER,name.c_str(),name.size());
+    std::memcpy(ptr+SLOT_HEADER+name.size(),data.c_str(),data.size());
+    
+    header->seq.store(seq+2,std::memory_order_release);
+}
+
+bool SharedCache::update(const string& name,Variant value)
+{
+    stringstream out;
+    xmlrpc::setup(out);
+    xmlrpc::create_value(value,out);
+    
+    string data=out.str();
+    
+    if (name.size()+data.size()>slot_size-SLOT_HEADER) {
+        // drop any previous value, it would be served as current
+        if (name.size()<=slot_size-SLOT_HEADER) {
+            write(name,Flags::Uncached,"");
+        }
+        
+        return false;
+    }
+    
+    write(name,Flags::Present,data);
+    
+    return true;
+}
+
+void SharedCache::remove(const string& name)
+{
+    if (name.size()>slot_size-SLOT_HEADER) {
+        return;
+    }
+    
+    write(name,Flags::Deleted,"");
+}
+
+void SharedCache::update(Variant variables)
+{
+    for (string& name : variables.keys()) {
+        update(name,variables[name]);
+    }
+}
+
+void SharedCache::invalidate(const string& name)
+{
+    if (writable and name.size()<=slot_size-SLOT_HEADER) {
+        write(name,Flags::Uncached,"");
+    }
+    
+    std::lock_guard<std::mutex> lock(written_mutex);
+    written[name]=now();
+}
+
+void SharedCache::touch()
+{
+    touch(std::chrono::system_clock::now());
+}
+
+void SharedCache::touch(std::chrono::system_clock::time_point checked)
+{
+    if (!writable) {
+        throw exception::CacheError(path,"opened read only");
+    }
+    
+    int64_t at=std::chrono::duration_cast<std::chrono::microseconds>(
+        checked.time_since_epoch()).count();
+    
+    touched_at()->store(at,std::memory_order_release);
+}
+
+bool SharedCache::writer()
+{
+    return writable;
+}
+
+string SharedCache::get_path()
+{
+    return path;
+}
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d-slowlog.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <ctime>
+#include <cerrno>
+
+#include <unistd.h>
+
+using namespace edupals;
+using namespace edupals::n4d;
+
+using namespace std;
+
+static int signal_pipe[2] = {-1,-1};
+static std::once_flag signal_once;
+static std::mutex signal_mutex;
+static vector<weak_ptr<SlowLog> > signal_logs;
+
+static void signal_handler(int)
+{
+    int saved=errno;
+    char c=0;
+    
+    // only async-signal-safe stuff here, real work is done by dumper thread
+    if (write(signal_pipe[1],&c,1)<0) {
+    }
+    
+    errno=saved;
+}
+
+static void signal_dumper()
+{
+    char c;
+    
+    while (true) {
+        ssize_t status=read(signal_pipe[0],&c,1);
+        
+        if (status<0 and errno==EINTR) {
+            continue;
+        }
+        
+        if (status<=0) {
+            break;
+        }
+        
+        std::lock_guard<std::mutex> lock(signal_mutex);
+        
+        for (weak_ptr<SlowLog>& ref : signal_logs) {
+            shared_ptr<SlowLog> log=ref.lock();
+            
+            if (log) {
+                log->dump(clog);
+            }
+        }
+    }
+}
+
+SlowLog::SlowLog(int64_t threshold,size_t capacity,size_t capture,uint32_t sample)
+{
+    this->threshold.store(threshold);
+    this->calls.store(0);
+    this->slow.store(0);
+    
+    this->capacity=(capacity>0) ? capacity : 1;
+    this->capture=capture;
+    this->rate=(sample>0) ? sample : 1;
+    this->head=0;
+}
+
+SlowLog::~SlowLog()
+{
+}
+
+bool SlowLog::sample()
+{
+    if (capture==0) {
+        return false;
+    }
+    
+    return (calls.fetch_add(1,std::memory_order_relaxed)%rate)==0;
+}
+
+void SlowLog::push(const Trace& trace)
+{
+    if (trace.total<threshold.load(std::memory_order_relaxed)) {
+        return;
+    }
+    
+    slow.fetch_add(1,std::memory_order_relaxed);
+    
+    SlowCall record;
+    record.when=std::chrono::system_clock::now();
+    record.trace=trace;
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    if (ring.size()<capacity) {
+        ring.push_back(record);
+    }
+    else {
+        ring[head]=record;
+    }
+    
+    head=(head+1)%capacity;
+}
+
+vector<SlowCall> SlowLog::records()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    vector<SlowCall> ret;
+    
+    if (ring.size()<capacity) {
+        ret=ring;
+    }
+    else {
+        for (size_t n=0;n<capacity;n++) {
+            ret.push_back(ring[(head+n)%capacity]);
+        }
+    }
+    
+    return ret;
+}
+
+void SlowLog::dump(ostream& out)
+{
+    vector<SlowCall> calls=records();
+    
+    out<<"**** slow calls ("<<calls.size()<<"/"<<count()<<") ****"<<endl;
+    
+    for (SlowCall& call : calls) {
+        std::time_t when=std::chrono::system_clock::to_time_t(call.when);
+        std::tm tm;
+        localtime_r(&when,&tm);
+        
+        Trace& t=call.trace;
+        
+        out<<std::put_time(&tm,"%Y-%m-%d %H:%M:%S")<<" "
+           <<t.name<<"::"<<t.method<<"() "
+           <<"total:"<<t.total<<"us "
+           <<"serialize:"<<t.serialize<<" dns:"<<t.dns<<" connect:"<<t.connect
+           <<" tls:"<<t.tls<<" ttfb:"<<t.ttfb<<" transfer:"<<t.transfer
+           <<" parse:"<<t.parse<<" validate:"<<t.validate<<" "
+           <<"out:"<<t.request_size<<"B in:"<<t.response_size<<"B "
+           <<"status:"<<t.status<<" curl:"<<t.curl_code
+           <<(t.success ? "" : " FAILED")<<endl;
+        
+        if (t.request.size()>0) {
+            out<<"    "<<t.request;
+            
+            if (t.request.size()<t.request_size) {
+                out<<"...";
+            }
+            
+            out<<endl;
+        }
+    }
+    
+    out<<"****************"<<endl;
+}
+
+void SlowLog::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    ring.clear();
+    head=0;
+}
+
+uint64_t SlowLog::count()
+{
+    return slow.load(std::memory_order_relaxed);
+}
+
+int64_t SlowLog::get_threshold()
+{
+    return threshold.load();
+}
+
+void SlowLog::set_threshold(int64_t threshold)
+{
+    this->threshold.store(threshold);
+}
+
+size_t SlowLog::get_capture()
+{
+    return capture;
+}
+
+void SlowLog::dump_on_signal(shared_ptr<SlowLog> log,int signum)
+{
+    std::call_once(signal_once,[]() {
+        if (pipe(signal_pipe)==0) {
+            std::thread(signal_dumper).detach();
+        }
+    });
+    
+    std::lock_guard<std::mutex> lock(signal_mutex);
+    signal_logs.push_back(log);
+    
+    struct sigaction action = {};
+    action.sa_handler=signal_handler;
+    action.sa_flags=SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    
+    sigaction(signum,&action,nullptr);
+}
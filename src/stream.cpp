@@ -0,0 +1,487 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d.hpp>
+#include <n4d-stream.hpp>
+
+#include "stream.hpp"
+#include "xmlrpc.hpp"
+#include "kernel.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+// longest entity, like &#x10FFFF;
+#define MAX_ENTITY 10
+
+using namespace edupals;
+using namespace edupals::variant;
+using namespace edupals::n4d;
+
+using namespace std;
+
+Variant Builder::get()
+{
+    return root;
+}
+
+void Builder::add(Variant value)
+{
+    if (stack.size()==0) {
+        root=value;
+        return;
+    }
+    
+    Variant& top=stack.back();
+    
+    if (top.type()==variant::Type::Array) {
+        top.append(value);
+    }
+    else if (names.size()>0) {
+        top[names.back()]=value;
+        names.pop_back();
+    }
+}
+
+void Builder::begin_array()
+{
+    stack.push_back(Variant::create_array(0));
+}
+
+void Builder::end_array()
+{
+    Variant value=stack.back();
+    stack.pop_back();
+    
+    add(value);
+}
+
+void Builder::begin_struct()
+{
+    stack.push_back(Variant::create_struct());
+}
+
+void Builder::member(const string& name)
+{
+    names.push_back(name);
+}
+
+void Builder::end_struct()
+{
+    Variant value=stack.back();
+    stack.pop_back();
+    
+    add(value);
+}
+
+void Builder::value(const Variant& value)
+{
+    add(value);
+}
+
+static bool scalar_type(const string& name)
+{
+    return (name=="int" or name=="i4" or name=="double" or name=="boolean" or
+            name=="string" or name=="dateTime.iso8601" or name=="base64");
+}
+
+xmlrpc::Reader::Reader(Visitor& visitor) :
+    target(&visitor), section(Section::Markup), checked(0), collecting(false), done(false)
+{
+}
+
+void xmlrpc::Reader::feed(const char* data,size_t size)
+{
+    // whole chunks are scanned in place, only an incomplete tail is kept
+    if (pending.size()==0) {
+        size_t used=scan(data,size);
+        pending.assign(data+used,size-used);
+    }
+    else {
+        pending.append(data,size);
+        pending.erase(0,scan(pending.c_str(),pending.size()));
+    }
+}
+
+// finds needle in [from,end), null if missing
+static const char* search(const char* from,const char* end,const char* needle)
+{
+    size_t size=std::strlen(needle);
+    
+    while (from+size<=end) {
+        const char* found=static_cast<const char*>(std::memchr(from,needle[0],end-from));
+        
+        if (!found or found+size>end) {
+            return nullptr;
+        }
+        
+        if (std::memcmp(found,needle,size)==0) {
+            return found;
+        }
+        
+        from=found+1;
+    }
+    
+    return nullptr;
+}
+
+static bool starts(const char* from,const char* end,const char* prefix)
+{
+    size_t size=std::strlen(prefix);
+    
+    return (from+size<=end and std::memcmp(from,prefix,size)==0);
+}
+
+size_t xmlrpc::Reader::scan(const char* data,size_t size)
+{
+    const char* pos=data;
+    const char* end=data+size;
+    
+    // bytes of a carried over tag already known to lack its '>'
+    size_t skip=checked;
+    checked=0;
+    
+    while (pos<end) {
+        if (section!=Section::Markup) {
+            bool cdata=(section==Section::CData);
+            const char* close=search(pos,end,cdata ? "]]>" : "-->");
+            
+            // a partial closing marker may be at the end
+            const char* stop=close ? close : std::max(pos,end-2);
+            
+            if (cdata and collecting) {
+                text.append(pos,stop-pos);
+            }
+            
+            pos=stop;
+            
+            if (!close) {
+                break;
+            }
+            
+            pos+=3;
+            section=Section::Markup;
+            continue;
+        }
+        
+        if (*pos!='<') {
+            size_t length=xmlrpc::kernel::find(pos,end-pos,'<');
+            const char* stop=pos+length;
+            
+            // text is handled as it arrives, except a trailing entity
+            // that may be incomplete
+            if (stop==end and collecting) {
+                const char* amp=static_cast<const char*>(memrchr(pos,'&',length));
+                
+                if (amp and end-amp<=MAX_ENTITY and !std::memchr(amp,';',end-amp)) {
+                    stop=amp;
+                }
+            }
+            
+            if (collecting) {
+                xmlrpc::kernel::unescape(pos,stop-pos,text);
+            }
+            
+            pos=stop;
+            
+            if (stop<end and *stop!='<') {
+                break;
+            }
+            
+            continue;
+        }
+        
+        if (starts(pos,end,"<!--")) {
+            pos+=4;
+            section=Section::Comment;
+            continue;
+        }
+        
+        if (starts(pos,end,"<![CDATA[")) {
+            pos+=9;
+            section=Section::CData;
+            continue;
+        }
+        
+        size_t from=std::min(skip,(size_t)(end-pos));
+        const char* gt=pos+from+xmlrpc::kernel::find(pos+from,end-pos-from,'>');
+        skip=0;
+        
+        if (gt==end) {
+            checked=end-pos;
+            break;
+        }
+        
+        char first=(pos+1<gt) ? pos[1] : '\0';
+        
+        if (first=='?' or first=='!') {
+            pos=gt+1;
+            continue;
+        }
+        
+        bool closing=(first=='/');
+        bool empty=(gt[-1]=='/');
+        
+        const char* name=pos+(closing ? 2 : 1);
+        const char* name_end=name;
+        
+        while (name_end<gt and *name_end!='/' and *name_end!=' ' and *name_end!='\t' and
+               *name_end!='\r' and *name_end!='\n') {
+            name_end++;
+        }
+        
+        tag.assign(name,name_end-name);
+        pos=gt+1;
+        
+        if (closing) {
+            close(tag);
+        }
+        else {
+            open(tag,empty);
+        }
+    }
+    
+    return pos-data;
+}
+
+void xmlrpc::Reader::finish()
+{
+    if (stack.size()>0 or section!=Section::Markup or pending.size()>0) {
+        throw exception::ServerError(0,"xml-rpc: truncated response");
+    }
+    
+    if (!done) {
+        throw exception::ServerError(0,"xml-rpc: missing return value");
+    }
+}
+
+void xmlrpc::Reader::open(const string& name,bool empty)
+{
+    if (stack.size()==0) {
+        if (name!="methodResponse") {
+            throw exception::ServerError(0,"xml-rpc: missing methodResponse node");
+        }
+    }
+    else {
+        Element& parent=stack.back();
+        
+        // fault value is built apart and thrown once complete
+        if (parent.name=="methodResponse" and name=="fault") {
+            target=&fault;
+        }
+        
+        if (parent.name=="value") {
+            parent.flag=true;
+            
+            if (scalar_type(name)) {
+                text.clear();
+                collecting=true;
+            }
+            
+            if (name=="struct") {
+                target->begin_struct();
+            }
+        }
+        
+        if (parent.name=="array" and name=="data") {
+            parent.flag=true;
+            target->begin_array();
+        }
+        
+        if (parent.name=="member" and name=="name") {
+            text.clear();
+            collecting=true;
+        }
+    }
+    
+    stack.push_back({name,false});
+    
+    if (empty) {
+        close(name);
+    }
+}
+
+void xmlrpc::Reader::close(const string& name)
+{
+    if (stack.size()==0 or stack.back().name!=name) {
+        throw exception::ServerError(0,"xml-rpc: unexpected closing tag "+name);
+    }
+    
+    Element element=stack.back();
+    stack.pop_back();
+    
+    string parent=(stack.size()>0) ? stack.back().name : "";
+    
+    if (parent=="value") {
+        if (scalar_type(name)) {
+            collecting=false;
+            scalar(name);
+        }
+        else if (name=="struct") {
+            target->end_struct();
+        }
+        // neither arrays without data nor unknown types have a value
+        else if (name!="array" or !element.flag) {
+            target->value(Variant());
+        }
+    }
+    
+    if (parent=="methodResponse" and name=="fault") {
+        throw_fault(fault.get());
+    }
+    
+    if (parent=="array" and name=="data") {
+        target->end_array();
+    }
+    
+    if (parent=="member" and name=="name") {
+        collecting=false;
+        target->member(text);
+    }
+    
+    if (name=="value") {
+        if (!element.flag) {
+            target->value(Variant());
+        }
+        
+        if (parent=="param") {
+            done=true;
+        }
+    }
+}
+
+void xmlrpc::Reader::scalar(const string& type)
+{
+    if (type=="int" or type=="i4") {
+        target->value(to_int32(text));
+    }
+    else if (type=="double") {
+        target->value(to_double(text));
+    }
+    else if (type=="boolean") {
+        target->value(to_int32(text)==1);
+    }
+    // datetime and base64 not fully supported, like parse_value
+    else {
+        target->value(text);
+    }
+}
+
+Envelope::Envelope(Visitor& visitor) : visitor(visitor), depth(0), forward(false), failed(false)
+{
+}
+
+Variant Envelope::response()
+{
+    return builder.get();
+}
+
+void Envelope::begin_array()
+{
+    if (forward) {
+        visitor.begin_array();
+    }
+    else {
+        builder.begin_array();
+    }
+    
+    depth++;
+}
+
+void Envelope::end_array()
+{
+    depth--;
+    
+    if (forward) {
+        visitor.end_array();
+        forward=(depth>1);
+    }
+    else {
+        builder.end_array();
+    }
+}
+
+void Envelope::begin_struct()
+{
+    if (forward) {
+        visitor.begin_struct();
+    }
+    else {
+        builder.begin_struct();
+    }
+    
+    depth++;
+}
+
+void Envelope::member(const string& name)
+{
+    if (forward) {
+        visitor.member(name);
+        return;
+    }
+    
+    builder.member(name);
+    
+    if (depth==1) {
+        this->name=name;
+        
+        if (name=="return" and !failed) {
+            // stands in for validation
+            builder.value(string());
+            forward=true;
+        }
+    }
+}
+
+void Envelope::end_struct()
+{
+    depth--;
+    
+    if (forward) {
+        visitor.end_struct();
+        forward=(depth>1);
+    }
+    else {
+        builder.end_struct();
+    }
+}
+
+void Envelope::value(const Variant& value)
+{
+    if (forward) {
+        visitor.value(value);
+        forward=(depth>1);
+        
+        return;
+    }
+    
+    builder.value(value);
+    
+    if (depth==1 and name=="status") {
+        Variant status=value;
+        
+        if (status.type()!=variant::Type::Int32 or status.get_int32()!=ErrorCode::CallSuccessful) {
+            failed=true;
+        }
+    }
+}
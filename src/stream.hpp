@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef EDUPALS_N4D_STREAM_READER
+#define EDUPALS_N4D_STREAM_READER
+
+#include <n4d-stream.hpp>
+#include <variant.hpp>
+
+#include <string>
+#include <vector>
+
+/*
+    Incremental xml-rpc decoding, used by streamed calls
+*/
+
+namespace edupals
+{
+    namespace n4d
+    {
+        namespace xmlrpc
+        {
+            /*!
+             * Incremental methodResponse reader, feeding visitor with its
+             * param value as bytes arrive. Only incomplete tags and
+             * entities are buffered, besides text of the scalar at hand.
+             * Throws Fault on fault responses and ServerError on malformed
+             * ones
+            */
+            class Reader
+            {
+                public:
+                
+                Reader(Visitor& visitor);
+                
+                void feed(const char* data,size_t size);
+                
+                /*!
+                 * Checks the whole document has been seen
+                */
+                void finish();
+                
+                protected:
+                
+                class Element
+                {
+                    public:
+                    
+                    std::string name;
+                    
+                    /*! type seen for values, data seen for arrays */
+                    bool flag;
+                };
+                
+                /*! visitor, or fault while reading a fault response */
+                Visitor* target;
+                Builder fault;
+                
+                /*! comments and cdata may span many chunks */
+                enum class Section
+                {
+                    Markup,
+                    Comment,
+                    CData
+                };
+                
+                Section section;
+                
+                /*! incomplete token, at most a tag or an entity */
+                std::string pending;
+                size_t checked;
+                
+                std::vector<Element> stack;
+                
+                std::string tag;
+                std::string text;
+                bool collecting;
+                bool done;
+                
+                /*!
+                 * Handles complete tokens, returns bytes used
+                */
+                size_t scan(const char* data,size_t size);
+                
+                void open(const std::string& name,bool empty);
+                void close(const std::string& name);
+                void scalar(const std::string& type);
+            };
+        }
+        
+        /*!
+         * Splits a N4D response: return value goes to visitor while the
+         * rest is built, so it can be validated as usual. Return value is
+         * only kept back when an error status comes before it
+        */
+        class Envelope: public Visitor
+        {
+            public:
+            
+            Envelope(Visitor& visitor);
+            
+            /*!
+             * Response with a placeholder as streamed return value
+            */
+            variant::Variant response();
+            
+            void begin_array() override;
+            void end_array() override;
+            void begin_struct() override;
+            void member(const std::string& name) override;
+            void end_struct() override;
+            void value(const variant::Variant& value) override;
+            
+            protected:
+            
+            Visitor& visitor;
+            Builder builder;
+            
+            int depth;
+            bool forward;
+            bool failed;
+            std::string name;
+        };
+    }
+}
+
+#endif
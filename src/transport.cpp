@@ -0,0 +1,298 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d-transport.hpp>
+
+#include "probes.hpp"
+
+#include <curl/curl.h>
+
+#include <exception>
+
+using namespace edupals;
+using namespace edupals::n4d;
+
+using namespace std;
+
+class CurlFactory
+{
+    public:
+        
+    bool ready;
+    
+    CurlFactory()
+    {
+        ready = (curl_global_init(CURL_GLOBAL_ALL)==0);
+    }
+    
+    ~CurlFactory()
+    {
+        if (ready) {
+            curl_global_cleanup();
+        }
+    }
+};
+
+//TODO: check about thread safety
+CurlFactory curl_instance;
+
+struct Transfer
+{
+    const Transport::Sink* sink;
+    const Message* message;
+    size_t received;
+    
+    // sink errors can not unwind through curl
+    std::exception_ptr error;
+};
+
+static size_t response_cb(char *ptr, size_t, size_t nmemb, void *userdata)
+{
+    Transfer* transfer=static_cast<Transfer*>(userdata);
+    
+    if (transfer->received==0) {
+        N4D_PROBE3(first_byte,transfer->message->name.c_str(),transfer->message->method.c_str(),nmemb);
+    }
+    
+    transfer->received+=nmemb;
+    
+    try {
+        (*transfer->sink)(ptr,nmemb);
+    }
+    catch (...) {
+        transfer->error=std::current_exception();
+        
+        // aborts transfer
+        return 0;
+    }
+    
+    return nmemb;
+}
+
+void Transport::post(const Message& message,const Sink& sink)
+{
+    string response;
+    
+    post(message,response);
+    sink(response.c_str(),response.size());
+}
+
+CurlTransport::CurlTransport() : connections(0), busy(0)
+{
+}
+
+CurlTransport::CurlTransport(size_t connections) : connections(connections), busy(0)
+{
+}
+
+CurlTransport::~CurlTransport()
+{
+    for (void* curl : idle) {
+        curl_easy_cleanup(static_cast<CURL*>(curl));
+    }
+}
+
+void* CurlTransport::acquire()
+{
+    if (connections==0) {
+        return curl_easy_init();
+    }
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    
+    available.wait(lock,[this]() {
+        return busy<connections;
+    });
+    
+    busy++;
+    
+    if (idle.size()>0) {
+        CURL* curl=static_cast<CURL*>(idle.back());
+        idle.pop_back();
+        
+        // keeps open connections and session cache
+        curl_easy_reset(curl);
+        
+        return curl;
+    }
+    
+    lock.unlock();
+    
+    CURL* curl=curl_easy_init();
+    
+    if (!curl) {
+        lock.lock();
+        busy--;
+        available.notify_one();
+    }
+    
+    return curl;
+}
+
+void CurlTransport::release(void* curl)
+{
+    if (connections==0) {
+        curl_easy_cleanup(static_cast<CURL*>(curl));
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    idle.push_back(curl);
+    busy--;
+    available.notify_one();
+}
+
+void CurlTransport::post(const Message& message,string& response)
+{
+    post(message,[&response](const char* data,size_t size) {
+        response.append(data,size);
+    });
+}
+
+void CurlTransport::post(const Message& message,const Sink& sink)
+{
+    const string prefix="unix://";
+    
+    if (message.address.compare(0,prefix.size(),prefix)==0) {
+        perform(message,"http://localhost/",message.address.substr(prefix.size()),sink);
+    }
+    else {
+        perform(message,message.address,"",sink);
+    }
+}
+
+void CurlTransport::perform(const Message& message,const string& url,const string& socket,const Sink& sink)
+{
+    CURL *curl;
+    CURLcode res;
+    Trace* trace=message.trace;
+    
+    if (!curl_instance.ready) {
+        throw exception::ServerError(0,"curl_global_init");
+    }
+    
+    curl = static_cast<CURL*>(acquire());
+    if(!curl) {
+        throw exception::ServerError(0,"curl_easy_init");
+    }
+    
+    // handles are used from many threads, timeouts must not rely on
+    // SIGALRM. Set on every request as curl_easy_reset clears it
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    // 1.0 closes connection after each request
+    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION,
+                     connections>0 ? CURL_HTTP_VERSION_1_1 : CURL_HTTP_VERSION_1_0);
+    
+    if (socket.size()>0) {
+        curl_easy_setopt(curl, CURLOPT_UNIX_SOCKET_PATH, socket.c_str());
+    }
+    
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
+    
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS,message.request.c_str());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE,static_cast<long>(message.request.size()));
+    
+    Transfer transfer;
+    transfer.sink=&sink;
+    transfer.message=&message;
+    transfer.received=0;
+    
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA,&transfer);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION,response_cb);
+
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, message.timeout);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, static_cast<long>(message.limit));
+    
+    res=curl_easy_perform(curl);
+    
+    if (trace) {
+        // curl reports each stage as seconds elapsed from the start
+        double namelookup=0.0;
+        double connect=0.0;
+        double appconnect=0.0;
+        double pretransfer=0.0;
+        double starttransfer=0.0;
+        double total=0.0;
+        
+        curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME, &namelookup);
+        curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME, &connect);
+        curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME, &appconnect);
+        curl_easy_getinfo(curl, CURLINFO_PRETRANSFER_TIME, &pretransfer);
+        curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME, &starttransfer);
+        curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &total);
+        
+        trace->dns=namelookup*1000000.0;
+        
+        if (connect>0.0) {
+            trace->connect=(connect-namelookup)*1000000.0;
+        }
+        
+        // appconnect is zero when there is no ssl handshake
+        if (appconnect>0.0) {
+            trace->tls=(appconnect-connect)*1000000.0;
+        }
+        
+        if (starttransfer>0.0) {
+            trace->ttfb=(starttransfer-pretransfer)*1000000.0;
+            trace->transfer=(total-starttransfer)*1000000.0;
+        }
+    }
+    
+    release(curl);
+    
+    if (transfer.error) {
+        std::rethrow_exception(transfer.error);
+    }
+    
+    if (res!=0) {
+        throw exception::ServerError(res,"curl_easy_perform");
+    }
+}
+
+UnixTransport::UnixTransport(string path) : path(path)
+{
+}
+
+void UnixTransport::post(const Message& message,string& response)
+{
+    post(message,[&response](const char* data,size_t size) {
+        response.append(data,size);
+    });
+}
+
+void UnixTransport::post(const Message& message,const Sink& sink)
+{
+    perform(message,message.address,path,sink);
+}
+
+LoopbackTransport::LoopbackTransport(Handler handler) : handler(handler)
+{
+}
+
+void LoopbackTransport::post(const Message& message,string& response)
+{
+    response=handler(message.request);
+}
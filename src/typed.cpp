@@ -0,0 +1,334 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d-typed.hpp>
+
+#include "xmlrpc.hpp"
+#include "kernel.hpp"
+
+#include <rapidxml/rapidxml.hpp>
+
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+
+using namespace edupals;
+using namespace edupals::variant;
+using namespace edupals::n4d;
+
+using namespace std;
+
+void typed::encode_text(const string& value,string& out)
+{
+    xmlrpc::kernel::escape(value.c_str(),value.size(),out);
+}
+
+void typed::encode_string(const string& value,string& out)
+{
+    out+="<value><string>";
+    xmlrpc::kernel::escape(value.c_str(),value.size(),out);
+    out+="</string></value>";
+}
+
+void typed::encode_base64(const uint8_t* data,size_t size,string& out)
+{
+    out.reserve(out.size()+((size+2)/3)*4+32);
+    
+    out+="<value><base64>";
+    xmlrpc::kernel::base64_encode(data,size,out);
+    out+="</base64></value>";
+}
+
+bool typed::decode_base64(const char* text,size_t size,vector<uint8_t>& out)
+{
+    out.clear();
+    
+    return xmlrpc::kernel::base64_decode(text,size,out);
+}
+
+void typed::encode_double(double value,string& out)
+{
+    // same as a C locale stream with precision 10 fixed
+    char buffer[400];
+    int size=std::snprintf(buffer,sizeof(buffer),"%.10f",value);
+    
+    for (int n=0;n<size;n++) {
+        if (buffer[n]==',') {
+            buffer[n]='.';
+        }
+    }
+    
+    out+="<value><double>";
+    out.append(buffer,size);
+    out+="</double></value>";
+}
+
+void typed::encode_variant(Variant value,string& out)
+{
+    stringstream stream;
+    xmlrpc::setup(stream);
+    xmlrpc::create_value(value,stream);
+    
+    out+=stream.str();
+}
+
+string typed::type_name(Variant value)
+{
+    switch (value.type()) {
+        case variant::Type::Boolean:
+            return "boolean";
+        
+        case variant::Type::Int32:
+            return "int";
+        
+        case variant::Type::Float:
+        case variant::Type::Double:
+            return "double";
+        
+        case variant::Type::String:
+            return "string";
+        
+        case variant::Type::Array:
+            return "array";
+        
+        case variant::Type::Struct:
+            return "struct";
+        
+        default:
+            return "none";
+    }
+}
+
+string typed::type_name(const Node& node)
+{
+    switch (node.type()) {
+        case variant::Type::Boolean:
+            return "boolean";
+        
+        case variant::Type::Int32:
+            return "int";
+        
+        case variant::Type::Double:
+            return "double";
+        
+        case variant::Type::String:
+            return "string";
+        
+        case variant::Type::Array:
+            return "array";
+        
+        case variant::Type::Struct:
+            return "struct";
+        
+        default:
+            return "none";
+    }
+}
+
+typedef rapidxml::xml_node<> XmlNode;
+
+// first element child of a <value>, the type node
+static XmlNode* type_node(void* value)
+{
+    XmlNode* node=static_cast<XmlNode*>(value)->first_node();
+    
+    if (node and node->type()!=rapidxml::node_element) {
+        return nullptr;
+    }
+    
+    return node;
+}
+
+typed::Node::Node() : value(nullptr), member_node(nullptr)
+{
+}
+
+typed::Node::Node(void* value,void* member) : value(value), member_node(member)
+{
+}
+
+bool typed::Node::valid() const
+{
+    return (value!=nullptr);
+}
+
+variant::Type typed::Node::type() const
+{
+    if (!value) {
+        return variant::Type::None;
+    }
+    
+    XmlNode* node=type_node(value);
+    
+    if (!node) {
+        return variant::Type::None;
+    }
+    
+    const char* name=node->name();
+    
+    if (std::strcmp(name,"int")==0 or std::strcmp(name,"i4")==0) {
+        return variant::Type::Int32;
+    }
+    
+    if (std::strcmp(name,"double")==0) {
+        return variant::Type::Double;
+    }
+    
+    if (std::strcmp(name,"boolean")==0) {
+        return variant::Type::Boolean;
+    }
+    
+    // datetime and base64 are handled as strings, like parse_value does
+    if (std::strcmp(name,"string")==0 or std::strcmp(name,"dateTime.iso8601")==0 or
+        std::strcmp(name,"base64")==0) {
+        return variant::Type::String;
+    }
+    
+    if (std::strcmp(name,"array")==0) {
+        return node->first_node("data") ? variant::Type::Array : variant::Type::None;
+    }
+    
+    if (std::strcmp(name,"struct")==0) {
+        return variant::Type::Struct;
+    }
+    
+    return variant::Type::None;
+}
+
+bool typed::Node::get_boolean() const
+{
+    return (xmlrpc::to_int32(type_node(value)->value())==1);
+}
+
+int32_t typed::Node::get_int32() const
+{
+    return xmlrpc::to_int32(type_node(value)->value());
+}
+
+double typed::Node::get_double() const
+{
+    return xmlrpc::to_double(type_node(value)->value());
+}
+
+string typed::Node::get_string() const
+{
+    XmlNode* node=type_node(value);
+    
+    return string(node->value(),node->value_size());
+}
+
+const char* typed::Node::data(size_t& size) const
+{
+    XmlNode* node=type_node(value);
+    size=node->value_size();
+    
+    return node->value();
+}
+
+typed::Node typed::Node::first() const
+{
+    XmlNode* node=type_node(value);
+    
+    if (!node) {
+        return Node();
+    }
+    
+    if (std::strcmp(node->name(),"array")==0) {
+        XmlNode* data=node->first_node("data");
+        
+        return Node(data ? data->first_node("value") : nullptr);
+    }
+    
+    if (std::strcmp(node->name(),"struct")==0) {
+        for (XmlNode* member=node->first_node("member");member;member=member->next_sibling("member")) {
+            XmlNode* member_value=member->first_node("value");
+            
+            if (member->first_node("name") and member_value) {
+                return Node(member_value,member);
+            }
+        }
+    }
+    
+    return Node();
+}
+
+typed::Node typed::Node::next() const
+{
+    if (!value) {
+        return Node();
+    }
+    
+    if (member_node) {
+        XmlNode* member=static_cast<XmlNode*>(member_node)->next_sibling("member");
+        
+        for (;member;member=member->next_sibling("member")) {
+            XmlNode* member_value=member->first_node("value");
+            
+            if (member->first_node("name") and member_value) {
+                return Node(member_value,member);
+            }
+        }
+        
+        return Node();
+    }
+    
+    return Node(static_cast<XmlNode*>(value)->next_sibling("value"));
+}
+
+string typed::Node::name() const
+{
+    if (!member_node) {
+        return "";
+    }
+    
+    XmlNode* node=static_cast<XmlNode*>(member_node)->first_node("name");
+    
+    return string(node->value(),node->value_size());
+}
+
+typed::Node typed::Node::member(const string& name) const
+{
+    if (type()!=variant::Type::Struct) {
+        return Node();
+    }
+    
+    for (Node member=first();member.valid();member=member.next()) {
+        XmlNode* node=static_cast<XmlNode*>(member.member_node)->first_node("name");
+        
+        if (name.size()==node->value_size() and
+            std::memcmp(name.c_str(),node->value(),name.size())==0) {
+            return member;
+        }
+    }
+    
+    return Node();
+}
+
+Variant typed::Node::to_variant() const
+{
+    if (!value) {
+        return Variant();
+    }
+    
+    return xmlrpc::parse_value(static_cast<XmlNode*>(value));
+}
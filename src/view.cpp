@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d-view.hpp>
+
+#include "xmlrpc.hpp"
+
+#include <rapidxml/rapidxml.hpp>
+
+#include <sstream>
+
+using namespace edupals;
+using namespace edupals::variant;
+using namespace edupals::n4d;
+
+using namespace std;
+
+/*
+    Response buffer and its rapidxml index, parsed in place
+*/
+class View::Document
+{
+    public:
+    
+    string buffer;
+    rapidxml::xml_document<> doc;
+};
+
+View::View()
+{
+}
+
+View::View(string incoming) : document(std::make_shared<Document>())
+{
+    document->buffer=std::move(incoming);
+    value=typed::Node(xmlrpc::response_value(document->doc,&document->buffer[0]));
+}
+
+View::View(Variant value) : document(std::make_shared<Document>())
+{
+    stringstream out;
+    xmlrpc::setup(out);
+    xmlrpc::create_value(value,out);
+    
+    document->buffer=out.str();
+    document->doc.parse<0>(&document->buffer[0]);
+    
+    this->value=typed::Node(document->doc.first_node("value"));
+}
+
+View::View(std::shared_ptr<Document> document,typed::Node value) : document(document), value(value)
+{
+}
+
+variant::Type View::type() const
+{
+    return value.type();
+}
+
+bool View::none() const
+{
+    return (value.type()==variant::Type::None);
+}
+
+size_t View::count() const
+{
+    size_t ret=0;
+    variant::Type type=value.type();
+    
+    if (type==variant::Type::Array or type==variant::Type::Struct) {
+        for (typed::Node item=value.first();item.valid();item=item.next()) {
+            ret++;
+        }
+    }
+    
+    return ret;
+}
+
+View View::operator[](size_t index) const
+{
+    if (value.type()!=variant::Type::Array) {
+        return View();
+    }
+    
+    typed::Node item=value.first();
+    
+    for (size_t n=0;n<index and item.valid();n++) {
+        item=item.next();
+    }
+    
+    if (!item.valid()) {
+        return View();
+    }
+    
+    return View(document,item);
+}
+
+View View::operator[](const string& name) const
+{
+    typed::Node member=value.member(name);
+    
+    if (!member.valid()) {
+        return View();
+    }
+    
+    return View(document,member);
+}
+
+View View::first() const
+{
+    typed::Node item=value.first();
+    
+    if (!item.valid()) {
+        return View();
+    }
+    
+    return View(document,item);
+}
+
+View View::next() const
+{
+    typed::Node item=value.next();
+    
+    if (!item.valid()) {
+        return View();
+    }
+    
+    return View(document,item);
+}
+
+string View::name() const
+{
+    return value.name();
+}
+
+vector<string> View::keys() const
+{
+    vector<string> ret;
+    
+    if (value.type()==variant::Type::Struct) {
+        for (typed::Node member=value.first();member.valid();member=member.next()) {
+            ret.push_back(member.name());
+        }
+    }
+    
+    return ret;
+}
+
+bool View::get_boolean() const
+{
+    return get<bool>();
+}
+
+int32_t View::get_int32() const
+{
+    return get<int32_t>();
+}
+
+double View::get_double() const
+{
+    return get<double>();
+}
+
+string View::get_string() const
+{
+    return get<string>();
+}
+
+Variant View::to_variant() const
+{
+    return value.to_variant();
+}
+
+const typed::Node& View::node() const
+{
+    return value;
+}
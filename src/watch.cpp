@@ -0,0 +1,383 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d-watch.hpp>
+#include <n4d-transport.hpp>
+
+#include "xmlrpc.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <algorithm>
+
+using namespace edupals;
+using namespace edupals::variant;
+using namespace edupals::n4d;
+
+using namespace std;
+
+/*
+    Adds a whole transfer limit to long-polls, other requests go untouched
+*/
+class Watcher::Poller: public Transport
+{
+    public:
+    
+    std::shared_ptr<Transport> transport;
+    std::atomic<int> wait;
+    
+    Poller(std::shared_ptr<Transport> transport) : transport(transport), wait(0)
+    {
+    }
+    
+    void post(const Message& message,string& response) override
+    {
+        if (message.method!="wait_changes") {
+            transport->post(message,response);
+            return;
+        }
+        
+        Message limited=message;
+        limited.limit=message.timeout+wait.load();
+        
+        transport->post(limited,response);
+    }
+    
+    void post(const Message& message,const Sink& sink) override
+    {
+        transport->post(message,sink);
+    }
+};
+
+Watcher::Watcher(Client client,int min_interval,int max_interval) :
+    client(client), min_interval(min_interval), max_interval(max_interval),
+    poll_timeout(30000), running(true), next_id(0),
+    mode(Mode::Unknown), serial(0)
+{
+    poller=std::make_shared<Poller>(this->client.get_transport());
+    this->client.set_transport(poller);
+    
+    worker=std::thread(&Watcher::worker_loop,this);
+}
+
+Watcher::~Watcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running=false;
+    }
+    
+    wake.notify_all();
+    worker.join();
+}
+
+int Watcher::watch(vector<string> names,WatchCallback callback)
+{
+    // a long-poll in flight only reports names already seen
+    try {
+        seed(names);
+    }
+    catch (std::exception& e) {
+        // worker seeds them once server is reachable
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    int id=next_id++;
+    watches[id]={names,callback};
+    wake.notify_all();
+    
+    return id;
+}
+
+void Watcher::unwatch(int id)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    watches.erase(id);
+}
+
+void Watcher::set_poll_timeout(int ms)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    poll_timeout=ms;
+}
+
+bool Watcher::long_poll()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return (mode==Mode::LongPoll);
+}
+
+void Watcher::seed(const vector<string>& names)
+{
+    vector<string> fresh;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        
+        for (const string& name : names) {
+            if (seen.find(name)==seen.end()) {
+                fresh.push_back(name);
+            }
+        }
+    }
+    
+    if (fresh.size()==0) {
+        return;
+    }
+    
+    vector<string> missing;
+    Variant values=client.get_variables(fresh,false,missing);
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    // names seeded meanwhile keep their value
+    for (string& name : values.keys()) {
+        seen.insert(std::make_pair(name,xmlrpc::digest(values[name])));
+    }
+    
+    for (string& name : missing) {
+        seen.insert(std::make_pair(name,uint64_t(0)));
+    }
+}
+
+vector<string> Watcher::names()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    vector<string> ret;
+    
+    for (auto& w : watches) {
+        for (string& name : w.second.names) {
+            if (std::find(ret.begin(),ret.end(),name)==ret.end()) {
+                ret.push_back(name);
+            }
+        }
+    }
+    
+    return ret;
+}
+
+void Watcher::worker_loop()
+{
+    int interval=min_interval;
+    
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            
+            wake.wait(lock,[this]() {
+                return (!running or watches.size()>0);
+            });
+            
+            if (!running) {
+                break;
+            }
+        }
+        
+        try {
+            if (mode==Mode::Unknown) {
+                try {
+                    // nothing changes after INT_MAX, so just current serial
+                    Variant response=client.builtin_call("get_changes",{INT_MAX});
+                    serial=(response/"serial"/variant::Type::Int32).get_int32();
+                    
+                    std::lock_guard<std::mutex> lock(mutex);
+                    mode=Mode::LongPoll;
+                }
+                catch (exception::UnknownMethod& e) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    mode=Mode::Polling;
+                }
+                catch (exception::Fault& e) {
+                    // other faults may be transient
+                    if (!e.missing("get_changes")) {
+                        throw;
+                    }
+                    
+                    std::lock_guard<std::mutex> lock(mutex);
+                    mode=Mode::Polling;
+                }
+            }
+            
+            // silently take current values of names watch could not seed
+            seed(names());
+            
+            map<string,Variant> values;
+            vector<string> deleted;
+            
+            if (mode==Mode::LongPoll and wait_changes(values,deleted)) {
+                dispatch(values,deleted);
+                interval=min_interval;
+                continue;
+            }
+            
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                
+                wake.wait_for(lock,std::chrono::milliseconds(interval),[this]() {
+                    return !running;
+                });
+                
+                if (!running) {
+                    break;
+                }
+            }
+            
+            read_all(values,deleted);
+            
+            if (dispatch(values,deleted)>0) {
+                interval=min_interval;
+            }
+            else {
+                interval=std::min(interval*2,max_interval);
+            }
+        }
+        catch (std::exception& e) {
+            // server unreachable, back off
+            std::unique_lock<std::mutex> lock(mutex);
+            
+            wake.wait_for(lock,std::chrono::milliseconds(interval),[this]() {
+                return !running;
+            });
+            
+            interval=std::min(interval*2,max_interval);
+        }
+    }
+}
+
+bool Watcher::wait_changes(map<string,Variant>& values,vector<string>& deleted)
+{
+    int timeout;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        timeout=poll_timeout;
+    }
+    
+    // server holds the request up to timeout
+    poller->wait.store(timeout);
+    
+    Variant response;
+    
+    try {
+        response=client.builtin_call("wait_changes",{(int)serial,timeout});
+    }
+    catch (exception::UnknownMethod& e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        mode=Mode::Polling;
+        
+        return false;
+    }
+    
+    Variant changes;
+    Variant removed;
+    int32_t last;
+    
+    try {
+        last=(response/"serial"/variant::Type::Int32).get_int32();
+        changes=response/"changed"/variant::Type::Struct;
+        removed=response/"deleted"/variant::Type::Array;
+    }
+    catch (variant::exception::NotFound& e) {
+        throw exception::InvalidBuiltInResponse("wait_changes","missing serial, changed or deleted");
+    }
+    
+    serial=last;
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    for (string& name : changes.keys()) {
+        if (seen.find(name)!=seen.end()) {
+            values[name]=changes[name];
+        }
+    }
+    
+    for (size_t n=0;n<removed.count();n++) {
+        string name=removed[n].get_string();
+        
+        if (seen.find(name)!=seen.end()) {
+            deleted.push_back(name);
+        }
+    }
+    
+    return true;
+}
+
+void Watcher::read_all(map<string,Variant>& values,vector<string>& deleted)
+{
+    vector<string> missing;
+    Variant response=client.get_variables(names(),false,missing);
+    
+    for (string& name : response.keys()) {
+        values[name]=response[name];
+    }
+    
+    for (string& name : missing) {
+        deleted.push_back(name);
+    }
+}
+
+size_t Watcher::dispatch(map<string,Variant>& values,vector<string>& deleted)
+{
+    map<string,Variant> changed;
+    map<int,Watch> current;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        
+        for (auto& value : values) {
+            uint64_t hash=xmlrpc::digest(value.second);
+            
+            if (seen[value.first]!=hash) {
+                seen[value.first]=hash;
+                changed[value.first]=value.second;
+            }
+        }
+        
+        for (string& name : deleted) {
+            if (seen[name]!=0) {
+                seen[name]=0;
+                changed[name]=Variant();
+            }
+        }
+        
+        current=watches;
+    }
+    
+    if (changed.size()==0) {
+        return 0;
+    }
+    
+    for (auto& w : current) {
+        for (string& name : w.second.names) {
+            auto it=changed.find(name);
+            
+            if (it!=changed.end()) {
+                w.second.callback(name,it->second);
+            }
+        }
+    }
+    
+    return changed.size();
+}
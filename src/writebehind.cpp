@@ -0,0 +1,346 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d-writebehind.hpp>
+#include <n4d-shm.hpp>
+
+#include "xmlrpc.hpp"
+
+#include <chrono>
+
+using namespace edupals;
+using namespace edupals::variant;
+using namespace edupals::n4d;
+
+using namespace std;
+
+WriteBehind::WriteBehind(Client sender,size_t max_pending,int interval) :
+    sender(sender), max_pending(max_pending), interval(interval), running(true)
+{
+    worker=std::thread(&WriteBehind::worker_loop,this);
+}
+
+WriteBehind::~WriteBehind()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running=false;
+    }
+    
+    wake.notify_all();
+    worker.join();
+    
+    map<string,exception_ptr> errors=flush();
+    
+    if (handler) {
+        for (auto& e : errors) {
+            handler(e.first,e.second);
+        }
+    }
+}
+
+void WriteBehind::push(string name,Write write)
+{
+    bool full;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        
+        if (writes.find(name)==writes.end()) {
+            order.push_back(name);
+        }
+        
+        writes[name]=write;
+        full=(writes.size()>=max_pending);
+    }
+    
+    if (full) {
+        wake.notify_all();
+    }
+}
+
+bool WriteBehind::find(const string& name,Write& write)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    auto it=writes.find(name);
+    
+    if (it!=writes.end()) {
+        write=it->second;
+        return true;
+    }
+    
+    it=flushing.find(name);
+    
+    if (it!=flushing.end()) {
+        write=it->second;
+        return true;
+    }
+    
+    return false;
+}
+
+vector<pair<string,WriteBehind::Write> > WriteBehind::pending()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    vector<pair<string,Write> > ret;
+    
+    for (auto& w : flushing) {
+        if (writes.find(w.first)==writes.end()) {
+            ret.push_back(w);
+        }
+    }
+    
+    for (string& name : order) {
+        ret.push_back(std::make_pair(name,writes[name]));
+    }
+    
+    return ret;
+}
+
+map<string,exception_ptr> WriteBehind::flush()
+{
+    std::lock_guard<std::mutex> flush_lock(flush_mutex);
+    
+    vector<string> names;
+    vector<Write> batch;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        
+        names.swap(order);
+        flushing.swap(writes);
+        writes.clear();
+        
+        for (string& name : names) {
+            batch.push_back(flushing[name]);
+        }
+    }
+    
+    if (names.size()>0) {
+        bool sent=false;
+        
+        if (names.size()>1 and sender.multicall->load()) {
+            sent=send_batch(names,batch);
+        }
+        
+        if (!sent) {
+            for (size_t n=0;n<names.size();n++) {
+                send(names[n],batch[n]);
+            }
+        }
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        flushing.clear();
+    }
+    
+    map<string,exception_ptr> ret;
+    ret.swap(failed);
+    
+    return ret;
+}
+
+void WriteBehind::send(const string& name,const Write& write)
+{
+    // errors were already routed through handle_variable_error
+    try {
+        if (write.type==Type::Set) {
+            sender.set_variable(name,write.value,write.attribs);
+        }
+        else {
+            sender.delete_variable(name);
+        }
+        
+        failed.erase(name);
+    }
+    catch (...) {
+        failed[name]=std::current_exception();
+    }
+}
+
+bool WriteBehind::send_batch(const vector<string>& names,const vector<Write>& batch)
+{
+    Variant calls = Variant::create_array(0);
+    
+    for (size_t n=0;n<names.size();n++) {
+        Variant call = Variant::create_struct();
+        Variant params = Variant::create_array(0);
+        
+        params.append(sender.credential.get());
+        params.append(names[n]);
+        
+        if (batch[n].type==Type::Set) {
+            params.append(batch[n].value);
+            params.append(batch[n].attribs);
+            call["methodName"]=string("set_variable");
+        }
+        else {
+            call["methodName"]=string("delete_variable");
+        }
+        
+        call["params"]=params;
+        calls.append(call);
+    }
+    
+    Variant results;
+    
+    try {
+        results=sender.rpc_call("system.multicall",{calls});
+    }
+    catch (exception::Fault& e) {
+        // calls fail inside results, so nothing was run: send them one
+        // by one
+        if (e.missing("system.multicall")) {
+            sender.multicall->store(false);
+        }
+        
+        return false;
+    }
+    catch (...) {
+        // batch may have been partially applied, so it is not resent
+        for (const string& name : names) {
+            failed[name]=std::current_exception();
+        }
+        
+        invalidate(names);
+        
+        return true;
+    }
+    
+    bool valid=(results.type()==variant::Type::Array and results.count()==names.size());
+    string plugin = "N4D";
+    string multicall = "system.multicall";
+    
+    for (size_t n=0;n<names.size();n++) {
+        string method=(batch[n].type==Type::Set) ? "set_variable" : "delete_variable";
+        
+        try {
+            if (!valid) {
+                throw exception::InvalidMethodResponse(plugin,multicall);
+            }
+            
+            Variant result=results[n];
+            
+            // a failed call comes as a fault struct
+            if (result.type()==variant::Type::Struct) {
+                xmlrpc::throw_fault(result);
+            }
+            
+            if (result.type()!=variant::Type::Array or result.count()!=1) {
+                throw exception::InvalidMethodResponse(plugin,method);
+            }
+            
+            try {
+                sender.validate(result[0],plugin,method);
+            }
+            catch (exception::CallFailed& e) {
+                sender.handle_variable_error(static_cast<VariableErrorCode>(e.code),names[n]);
+                
+                throw;
+            }
+            
+            failed.erase(names[n]);
+        }
+        catch (...) {
+            failed[names[n]]=std::current_exception();
+        }
+    }
+    
+    invalidate(names);
+    
+    return true;
+}
+
+void WriteBehind::invalidate(const vector<string>& names)
+{
+    if (!sender.shared_cache) {
+        return;
+    }
+    
+    for (const string& name : names) {
+        sender.shared_cache->invalidate(name);
+    }
+}
+
+void WriteBehind::set_sender(Client sender)
+{
+    std::lock_guard<std::mutex> flush_lock(flush_mutex);
+    this->sender=sender;
+}
+
+void WriteBehind::set_error_handler(WriteErrorHandler handler)
+{
+    std::lock_guard<std::mutex> flush_lock(flush_mutex);
+    this->handler=handler;
+}
+
+void WriteBehind::worker_loop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    
+    // a full queue is checked on wake up, a notify sent while flushing
+    // would be lost otherwise
+    auto ready = [&] {
+        return (!running or writes.size()>=max_pending);
+    };
+    
+    while (running) {
+        if (interval>0) {
+            wake.wait_for(lock,std::chrono::milliseconds(interval),ready);
+        }
+        else {
+            wake.wait(lock,ready);
+        }
+        
+        if (!running or writes.size()==0) {
+            continue;
+        }
+        
+        lock.unlock();
+        
+        map<string,exception_ptr> errors=flush();
+        WriteErrorHandler current;
+        
+        {
+            std::lock_guard<std::mutex> flush_lock(flush_mutex);
+            
+            current=handler;
+            
+            if (!current) {
+                // keep them for next explicit flush
+                for (auto& e : errors) {
+                    failed[e.first]=e.second;
+                }
+            }
+        }
+        
+        // handler may flush or replace itself
+        if (current) {
+            for (auto& e : errors) {
+                current(e.first,e.second);
+            }
+        }
+        
+        lock.lock();
+    }
+}
@@ -0,0 +1,616 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <n4d.hpp>
+
+#include "xmlrpc.hpp"
+#include "kernel.hpp"
+
+#include <iomanip>
+#include <sstream>
+#include <cstring>
+#include <vector>
+#include <thread>
+#include <exception>
+#include <algorithm>
+
+using namespace edupals;
+using namespace edupals::variant;
+using namespace edupals::n4d;
+
+using namespace rapidxml;
+
+using namespace std;
+
+void xmlrpc::setup(ostream& out)
+{
+    out.imbue(std::locale("C"));
+    out<<std::setprecision(10)<<std::fixed;
+}
+
+int32_t xmlrpc::to_int32(const string& value)
+{
+    stringstream in;
+    in.imbue(std::locale("C"));
+    in.str(value);
+    int ivalue=0;
+    in>>ivalue;
+    
+    return ivalue;
+}
+
+double xmlrpc::to_double(const string& value)
+{
+    stringstream in;
+    in.imbue(std::locale("C"));
+    in.str(value);
+    double dvalue=0.0;
+    in>>dvalue;
+    
+    return dvalue;
+}
+
+// parses a scalar type node, None for unknown types
+static Variant parse_scalar(rapidxml::xml_node<>* node)
+{
+    Variant ret;
+    
+    string name = node->name();
+    string value = node->value();
+    
+    if (name=="int" or name=="i4") {
+        ret=xmlrpc::to_int32(value);
+    }
+    
+    if (name=="double") {
+        ret=xmlrpc::to_double(value);
+    }
+    
+    if (name=="boolean") {
+        ret=(xmlrpc::to_int32(value)==1);
+    }
+    
+    if (name=="string") {
+        ret=value;
+    }
+    
+    // datetime and base64 not fully supported, return as string
+    if (name=="dateTime.iso8601") {
+        ret=value;
+    }
+    
+    if (name=="base64") {
+        ret=value;
+    }
+    
+    return ret;
+}
+
+Variant xmlrpc::parse_value(rapidxml::xml_node<>* node_value)
+{
+    return parse_value(node_value,nullptr);
+}
+
+Variant xmlrpc::parse_value(rapidxml::xml_node<>* node_value,Interner* interner)
+{
+    Variant ret;
+    
+    rapidxml::xml_node<>* node = node_value->first_node();
+    
+    //nothing?
+    if (!node) {
+        return ret;
+    }
+    
+    string name = node->name();
+    
+    if (name=="array") {
+        rapidxml::xml_node<>* node_data = node->first_node("data");
+        
+        if (node_data) {
+            ret=Variant::create_array(0);
+            rapidxml::xml_node<>* node_value = node_data->first_node("value");
+            
+            while(node_value) {
+                ret.append(parse_value(node_value,interner));
+                node_value = node_value->next_sibling("value");
+            }
+        }
+    }
+    else if (name=="struct") {
+        rapidxml::xml_node<>* node_member = node->first_node("member");
+        ret=Variant::create_struct();
+        
+        while (node_member) {
+            rapidxml::xml_node<>* node_name = node_member->first_node("name");
+            rapidxml::xml_node<>* node_value = node_member->first_node("value");
+            
+            if (node_name and node_value) {
+                ret[node_name->value()]=parse_value(node_value,interner);
+            }
+            
+            node_member=node_member->next_sibling("member");
+        }
+    }
+    else if (interner) {
+        ret=interner->scalar(node);
+    }
+    else {
+        ret=parse_scalar(node);
+    }
+    
+    return ret;
+}
+
+xmlrpc::Interner::Interner(size_t capacity,size_t max_length) :
+    used(0), capacity(std::max<size_t>(capacity,64)), max_length(max_length)
+{
+}
+
+void xmlrpc::Interner::grow()
+{
+    vector<Entry> old;
+    old.swap(entries);
+    
+    entries.resize(old.size()>0 ? old.size()*2 : 64);
+    size_t mask=entries.size()-1;
+    
+    for (Entry& entry : old) {
+        if (entry.text.size()==0) {
+            continue;
+        }
+        
+        size_t n=entry.hash & mask;
+        
+        while (entries[n].text.size()>0) {
+            n=(n+1) & mask;
+        }
+        
+        entries[n]=std::move(entry);
+    }
+}
+
+Variant xmlrpc::Interner::scalar(rapidxml::xml_node<>* node)
+{
+    size_t name_size=node->name_size();
+    size_t value_size=node->value_size();
+    
+    if (value_size>max_length) {
+        return parse_scalar(node);
+    }
+    
+    if (used*2>=entries.size() and entries.size()<capacity) {
+        grow();
+    }
+    
+    // FNV-1a over type name, a separator and text
+    uint64_t hash=0xcbf29ce484222325ULL;
+    
+    for (size_t n=0;n<name_size;n++) {
+        hash=(hash ^ static_cast<unsigned char>(node->name()[n]))*0x100000001b3ULL;
+    }
+    
+    hash=hash*0x100000001b3ULL;
+    
+    for (size_t n=0;n<value_size;n++) {
+        hash=(hash ^ static_cast<unsigned char>(node->value()[n]))*0x100000001b3ULL;
+    }
+    
+    size_t mask=entries.size()-1;
+    size_t n=hash & mask;
+    size_t size=name_size+1+value_size;
+    
+    while (entries[n].text.size()>0) {
+        Entry& entry=entries[n];
+        
+        if (entry.hash==hash and entry.text.size()==size and
+            std::memcmp(entry.text.c_str(),node->name(),name_size)==0 and
+            std::memcmp(entry.text.c_str()+name_size+1,node->value(),value_size)==0) {
+            return entry.value;
+        }
+        
+        n=(n+1) & mask;
+    }
+    
+    Variant ret=parse_scalar(node);
+    
+    // a full table keeps serving what it has
+    if (used*4<entries.size()*3) {
+        Entry& entry=entries[n];
+        
+        entry.hash=hash;
+        entry.text.assign(node->name(),name_size);
+        entry.text+='\0';
+        entry.text.append(node->value(),value_size);
+        entry.value=ret;
+        
+        used++;
+    }
+    
+    return ret;
+}
+
+Variant xmlrpc::parse_value(rapidxml::xml_node<>* node_value,const Decoding& decoding)
+{
+    if (decoding.threshold==0 or decoding.threads<2) {
+        return parse_value(node_value,decoding.interner);
+    }
+    
+    rapidxml::xml_node<>* node = node_value->first_node();
+    
+    if (!node) {
+        return Variant();
+    }
+    
+    string name = node->name();
+    
+    // item values, and member names for structs
+    vector<rapidxml::xml_node<>*> values;
+    vector<rapidxml::xml_node<>*> names;
+    
+    if (name=="array") {
+        rapidxml::xml_node<>* node_data = node->first_node("data");
+        
+        if (!node_data) {
+            return Variant();
+        }
+        
+        for (rapidxml::xml_node<>* item=node_data->first_node("value");item;item=item->next_sibling("value")) {
+            values.push_back(item);
+        }
+    }
+    else if (name=="struct") {
+        for (rapidxml::xml_node<>* member=node->first_node("member");member;member=member->next_sibling("member")) {
+            rapidxml::xml_node<>* node_name = member->first_node("name");
+            rapidxml::xml_node<>* member_value = member->first_node("value");
+            
+            if (node_name and member_value) {
+                names.push_back(node_name);
+                values.push_back(member_value);
+            }
+        }
+    }
+    else {
+        return parse_value(node_value,decoding.interner);
+    }
+    
+    vector<Variant> items(values.size());
+    
+    if (values.size()>=decoding.threshold) {
+        size_t threads=std::min(decoding.threads,values.size());
+        size_t chunk=(values.size()+threads-1)/threads;
+        
+        vector<std::exception_ptr> errors(threads);
+        vector<std::thread> workers;
+        
+        auto decode=[&](size_t worker) {
+            try {
+                size_t last=std::min(values.size(),(worker+1)*chunk);
+                
+                // interners are not shared among threads
+                Interner local;
+                Interner* interner=nullptr;
+                
+                if (decoding.interner) {
+                    interner=(worker==0) ? decoding.interner : &local;
+                }
+                
+                for (size_t n=worker*chunk;n<last;n++) {
+                    items[n]=parse_value(values[n],interner);
+                }
+            }
+            catch (...) {
+                errors[worker]=std::current_exception();
+            }
+        };
+        
+        // caller takes first chunk
+        for (size_t worker=1;worker<threads;worker++) {
+            workers.push_back(std::thread(decode,worker));
+        }
+        
+        decode(0);
+        
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        
+        for (std::exception_ptr& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+    else {
+        // a large container may still be further down
+        for (size_t n=0;n<values.size();n++) {
+            items[n]=parse_value(values[n],decoding);
+        }
+    }
+    
+    Variant ret;
+    
+    if (name=="array") {
+        ret=Variant::create_array(0);
+        
+        for (Variant& item : items) {
+            ret.append(item);
+        }
+    }
+    else {
+        ret=Variant::create_struct();
+        
+        for (size_t n=0;n<items.size();n++) {
+            ret[names[n]->value()]=items[n];
+        }
+    }
+    
+    return ret;
+}
+
+void xmlrpc::throw_fault(Variant value)
+{
+    int32_t code=0;
+    string msg;
+    
+    try {
+        code=(value/"faultCode"/variant::Type::Int32).get_int32();
+        msg=(value/"faultString"/variant::Type::String).get_string();
+    }
+    catch (variant::exception::NotFound& e) {
+        // a malformed fault is still a fault
+    }
+    
+    throw exception::Fault(code,msg);
+}
+
+rapidxml::xml_node<>* xmlrpc::response_value(rapidxml::xml_document<>& doc,char* buffer)
+{
+    try {
+        doc.parse<0>(buffer);
+    }
+    catch (rapidxml::parse_error& ex) {
+        throw exception::ServerError(0,ex.what());
+    }
+    
+    rapidxml::xml_node<>* node_method = doc.first_node("methodResponse");
+    
+    if (!node_method) {
+        throw exception::ServerError(0,"xml-rpc: missing methodResponse node");
+    }
+    
+    rapidxml::xml_node<>* node_params = node_method->first_node();
+    
+    if (!node_params) {
+        throw exception::ServerError(0,"xml-rpc: missing params or fault node");
+    }
+    
+    string node_name=node_params->name();
+    
+    if (node_name=="fault") {
+        rapidxml::xml_node<>* node_value=node_params->first_node("value");
+        
+        throw_fault(node_value ? parse_value(node_value) : Variant());
+    }
+    
+    if (node_name=="params") {
+        rapidxml::xml_node<>* node_param=node_params->first_node("param");
+        
+        if (node_param) {
+            rapidxml::xml_node<>* node_value=node_param->first_node("value");
+            
+            // an empty value would be parsed as none
+            if (node_value and node_value->first_node()) {
+                return node_value;
+            }
+        }
+    }
+    
+    throw exception::ServerError(0,"xml-rpc: missing return value");
+}
+
+Variant xmlrpc::parse_response(const string& incoming)
+{
+    return parse_response(incoming,{0,0});
+}
+
+Variant xmlrpc::parse_response(const string& incoming,const Decoding& decoding)
+{
+    xml_document<> doc;
+    std::vector<char> buffer(incoming.c_str(),incoming.c_str()+incoming.size()+1);
+    
+    rapidxml::xml_node<>* node_value=response_value(doc,buffer.data());
+    Variant ret=parse_value(node_value,decoding);
+    
+    if (ret.none()) {
+        throw exception::ServerError(0,"xml-rpc: missing return value");
+    }
+    
+    return ret;
+}
+
+Variant xmlrpc::parse_request(const string& incoming,string& method)
+{
+    Variant ret=Variant::create_array(0);
+    xml_document<> doc;
+    
+    vector<char> memxml(incoming.begin(),incoming.end());
+    memxml.push_back(0);
+    
+    try {
+        doc.parse<0>(memxml.data());
+    }
+    catch (rapidxml::parse_error& ex) {
+        throw exception::ServerError(0,ex.what());
+    }
+    
+    rapidxml::xml_node<>* node_call = doc.first_node("methodCall");
+    
+    if (!node_call) {
+        throw exception::ServerError(0,"xml-rpc: missing methodCall node");
+    }
+    
+    rapidxml::xml_node<>* node_name = node_call->first_node("methodName");
+    
+    if (!node_name) {
+        throw exception::ServerError(0,"xml-rpc: missing methodName node");
+    }
+    
+    method=node_name->value();
+    
+    rapidxml::xml_node<>* node_params = node_call->first_node("params");
+    
+    if (node_params) {
+        rapidxml::xml_node<>* node_param = node_params->first_node("param");
+        
+        while (node_param) {
+            rapidxml::xml_node<>* node_value = node_param->first_node("value");
+            
+            if (node_value) {
+                ret.append(parse_value(node_value));
+            }
+            
+            node_param = node_param->next_sibling("param");
+        }
+    }
+    
+    return ret;
+}
+
+// writes value as character data
+static void write_text(const string& value,ostream& out)
+{
+    if (xmlrpc::kernel::find_markup(value.c_str(),value.size())==value.size()) {
+        out<<value;
+        return;
+    }
+    
+    string escaped;
+    xmlrpc::kernel::escape(value.c_str(),value.size(),escaped);
+    out<<escaped;
+}
+
+void xmlrpc::create_value(Variant value, ostream& out)
+{
+    
+    out<<"<value>";
+    switch (value.type()) {
+        
+        case variant::Type::None:
+            out<<"<nil/>";
+        break;
+            
+        case variant::Type::Boolean:
+            out<<"<boolean>";
+            if (value.get_boolean()) {
+                out<<"1";
+            }
+            else {
+                out<<"0";
+            }
+            out<<"</boolean>";
+        break;
+        
+        case variant::Type::Int32:
+            out<<"<int>";
+            out<<value.get_int32();
+            out<<"</int>";
+        break;
+        
+        // floats are encoded as doubles (losing precission)
+        case variant::Type::Float:
+            out<<"<double>";
+            out<<value.get_float();
+            out<<"</double>";
+        break;
+        
+        case variant::Type::Double:
+            out<<"<double>";
+            out<<value.get_double();
+            out<<"</double>";
+        break;
+        
+        case variant::Type::String:
+            out<<"<string>";
+            write_text(value.get_string(),out);
+            out<<"</string>";
+        break;
+        
+        case variant::Type::Array:
+            out<<"<array>";
+            out<<"<data>";
+                for(size_t n=0;n<value.count();n++) {
+                    create_value(value[n],out);
+                }
+            out<<"</data>";
+            out<<"</array>";
+        break;
+        
+        case variant::Type::Struct:
+            out<<"<struct>";
+            
+            for (string& key: value.keys()) {
+                out<<"<member>";
+                out<<"<name>";
+                write_text(key,out);
+                out<<"</name>";
+                
+                create_value(value[key],out);
+                
+                out<<"</member>";
+            }
+            
+            out<<"</struct>";
+        break;
+    }
+    out<<"</value>";
+}
+
+void xmlrpc::create_response(Variant value,ostream& out)
+{
+    out<<"<?xml version=\"1.0\"?>";
+    out<<"<methodResponse>";
+        out<<"<params>";
+            out<<"<param>";
+                create_value(value,out);
+            out<<"</param>";
+        out<<"</params>";
+    out<<"</methodResponse>";
+}
+
+uint64_t xmlrpc::digest(Variant value)
+{
+    stringstream out;
+    setup(out);
+    create_value(value,out);
+    
+    string data=out.str();
+    uint64_t hash=14695981039346656037ULL;
+    
+    for (char c : data) {
+        hash^=(unsigned char)c;
+        hash*=1099511628211ULL;
+    }
+    
+    return hash;
+}
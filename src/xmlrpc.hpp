@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2026 Edupals project
+ *
+ * Author:
+ *  Enrique Medina Gremaldos <quiqueiii@gmail.com>
+ *
+ * Source:
+ *  https://github.com/edupals/edupals-n4d-toolkit
+ *
+ * This file is a part of edupals-n4d-toolkit.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef EDUPALS_N4D_XMLRPC
+#define EDUPALS_N4D_XMLRPC
+
+#include <variant.hpp>
+
+#include <rapidxml/rapidxml.hpp>
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+
+/*
+    xml-rpc encoding shared by Client and in-tree servers and tools
+*/
+
+namespace edupals
+{
+    namespace n4d
+    {
+        namespace xmlrpc
+        {
+            /*!
+             * Parses a <value> node
+            */
+            variant::Variant parse_value(rapidxml::xml_node<>* node_value);
+            
+            /*!
+             * Shares decoded scalars with the same type and text, so
+             * repeated values of a response, or of many responses, point
+             * to a single Variant. Table grows up to capacity entries, 64 at
+             * least, and texts longer than max_length are never interned
+            */
+            class Interner
+            {
+                public:
+                
+                Interner(size_t capacity = 4096,size_t max_length = 64);
+                
+                /*!
+                 * Gets the Variant of a scalar <value> type node, parsing
+                 * it on first sight
+                */
+                variant::Variant scalar(rapidxml::xml_node<>* node);
+                
+                /*!
+                 * Held while decoding with a long lived interner
+                */
+                std::mutex mutex;
+                
+                protected:
+                
+                class Entry
+                {
+                    public:
+                    
+                    uint64_t hash;
+                    std::string text;
+                    variant::Variant value;
+                };
+                
+                std::vector<Entry> entries;
+                size_t used;
+                size_t capacity;
+                size_t max_length;
+                
+                void grow();
+            };
+            
+            /*!
+             * Parses a <value> node, sharing scalars through interner if
+             * not null
+            */
+            variant::Variant parse_value(rapidxml::xml_node<>* node_value,Interner* interner);
+            
+            /*!
+             * Parallel decoding settings: arrays and structs with at
+             * least threshold items are split among threads. A threshold
+             * of 0 or less than two threads decodes serially
+            */
+            class Decoding
+            {
+                public:
+                
+                size_t threshold;
+                size_t threads;
+                
+                /*! shared scalars, each thread gets its own when decoding in parallel */
+                Interner* interner = nullptr;
+            };
+            
+            /*!
+             * Parses a <value> node, decoding its first large enough
+             * containers in parallel
+            */
+            variant::Variant parse_value(rapidxml::xml_node<>* node_value,const Decoding& decoding);
+            
+            /*!
+             * Throws Fault for a fault response value
+            */
+            [[noreturn]] void throw_fault(variant::Variant value);
+            
+            /*!
+             * Parses a methodResponse document held in buffer, returning
+             * its <value> node. Throws Fault on fault responses and
+             * ServerError on malformed ones
+            */
+            rapidxml::xml_node<>* response_value(rapidxml::xml_document<>& doc,char* buffer);
+            
+            /*!
+             * Scalar conversions, C locale
+            */
+            int32_t to_int32(const std::string& value);
+            double to_double(const std::string& value);
+            
+            /*!
+             * Parses a methodResponse document
+            */
+            variant::Variant parse_response(const std::string& incoming);
+            
+            variant::Variant parse_response(const std::string& incoming,const Decoding& decoding);
+            
+            /*!
+             * Parses a methodCall document, returning its params as an array
+            */
+            variant::Variant parse_request(const std::string& incoming,std::string& method);
+            
+            /*!
+             * Writes value as a <value> node
+            */
+            void create_value(variant::Variant value,std::ostream& out);
+            
+            /*!
+             * Writes a methodResponse document with value as its only param
+            */
+            void create_response(variant::Variant value,std::ostream& out);
+            
+            /*!
+             * Sets C locale and double precision used on the wire
+            */
+            void setup(std::ostream& out);
+            
+            /*!
+             * FNV-1a hash of the wire encoding of value
+            */
+            uint64_t digest(variant::Variant value);
+        }
+    }
+}
+
+#endif